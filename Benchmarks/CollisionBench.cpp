@@ -0,0 +1,85 @@
+#define SDL_MAIN_HANDLED
+#include "../Engine/Collision.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Compares overlapBatch against the scalar kernel for one target against
+// batches of bullets. Bullets are uniformly spread over the screen, with the
+// size and target used by the game.
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Kernel = std::size_t (*)(const Rectf &, const float *, const float *,
+                               const float *, const float *, std::size_t,
+                               unsigned int *);
+
+struct Bullets {
+  std::vector<float> x, y, w, h;
+  std::vector<unsigned int> hits;
+};
+
+Bullets makeBullets(const std::size_t count) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> pos(0.0f, 1.0f);
+  Bullets bullets;
+  for (std::size_t i = 0; i < count; ++i) {
+    bullets.x.push_back(pos(rng));
+    bullets.y.push_back(pos(rng));
+    bullets.w.push_back(0.02f);
+    bullets.h.push_back(0.02f);
+  }
+  bullets.hits.resize(count);
+  return bullets;
+}
+
+double nsPerBullet(Kernel kernel, const Rectf &target, Bullets &bullets,
+                   std::size_t &nHits) {
+  const std::size_t count = bullets.x.size();
+  const std::size_t repetitions = 20000000 / count + 1;
+  const auto start = Clock::now();
+  for (std::size_t r = 0; r < repetitions; ++r) {
+    nHits = kernel(target, bullets.x.data(), bullets.y.data(),
+                   bullets.w.data(), bullets.h.data(), count,
+                   bullets.hits.data());
+  }
+  const std::chrono::duration<double, std::nano> elapsed =
+      Clock::now() - start;
+  return elapsed.count() / double(repetitions * count);
+}
+
+} // namespace
+
+int main() {
+  const Rectf target = {0.45f, 0.45f, 0.1f, 0.1f};
+  std::printf("%10s %14s %14s %10s %8s\n", "bullets", "scalar ns/b",
+              "batch ns/b", "speedup", "hits");
+  for (const std::size_t count : {1000, 10000, 100000}) {
+    Bullets bullets = makeBullets(count);
+    std::size_t scalarHits = 0;
+    std::size_t batchHits = 0;
+    const double scalar =
+        nsPerBullet(overlapBatchScalar, target, bullets, scalarHits);
+    // Both kernels write to the same buffer, keep the reference hits
+    const std::vector<unsigned int> expected(
+        bullets.hits.begin(), bullets.hits.begin() + scalarHits);
+    const double batch = nsPerBullet(overlapBatch, target, bullets, batchHits);
+    std::printf("%10zu %14.3f %14.3f %9.2fx %8zu\n", count, scalar, batch,
+                scalar / batch, batchHits);
+    if (scalarHits != batchHits) {
+      std::printf("hit count mismatch: scalar %zu, batch %zu\n", scalarHits,
+                  batchHits);
+      return EXIT_FAILURE;
+    }
+    for (std::size_t i = 0; i < batchHits; ++i) {
+      if (bullets.hits[i] != expected[i]) {
+        std::printf("hit %zu mismatch: scalar %u, batch %u\n", i,
+                    expected[i], bullets.hits[i]);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
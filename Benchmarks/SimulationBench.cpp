@@ -0,0 +1,38 @@
+#define SDL_MAIN_HANDLED
+#include "../Game/Game.h"
+#include <cstdio>
+#include <cstdlib>
+
+// Runs the game model headless on a synthetic input script and reports its
+// throughput. Built with TRACK_ALLOCATIONS, it also asserts that model
+// updates past the warm-up do not allocate and reports the heap
+// allocations of the measured run.
+// Usage: simulationBench [ticks] [bullets]
+int main(int argc, char *argv[]) {
+  const unsigned int ticks = argc > 1 ? std::atoi(argv[1]) : 10000;
+  const unsigned int bullets = argc > 2 ? std::atoi(argv[2]) : 10000;
+
+  Game game(true);
+  if (!game.isInitialized()) {
+    return EXIT_FAILURE;
+  }
+
+  // Warm up, so buffers reach their working size before counting
+  game.RunBenchmark(ticks / 10 + 1, bullets);
+  game.setAllocationChecks(true);
+
+  const Uint64 before = getAllocationCount();
+  const BenchmarkStats stats = game.RunBenchmark(ticks, bullets);
+  const Uint64 allocated = getAllocationCount() - before;
+
+  std::printf("%u ticks in %.3f s: %.0f ticks/s\n", stats.ticks,
+              stats.seconds, stats.ticksPerSecond);
+  std::printf("%.0f entities on average, %.2f ns per entity and tick\n",
+              stats.meanEntities, stats.nsPerEntity);
+  if (isTrackingAllocations()) {
+    std::printf("%llu allocations, %.3f per tick\n",
+                static_cast<unsigned long long>(allocated),
+                stats.ticks > 0 ? double(allocated) / stats.ticks : 0.0);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+#include "Allocations.h"
+#include <cassert>
+
+#ifdef TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<Uint64> allocations{0};
+
+} // namespace
+
+// Array and nothrow forms forward to this one
+void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+bool isTrackingAllocations() { return true; }
+
+Uint64 getAllocationCount() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool isTrackingAllocations() { return false; }
+
+Uint64 getAllocationCount() { return 0; }
+
+#endif
+
+// NO ALLOCATION SCOPE START
+NoAllocationScope::~NoAllocationScope() {
+  assert(!m_enabled || getAllocationCount() == m_start);
+}
+// NO ALLOCATION SCOPE END
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// Heap allocation tracking. Builds defining TRACK_ALLOCATIONS replace the
+// global operator new to count every allocation, other builds count
+// nothing and the checks below never fire.
+bool isTrackingAllocations();
+Uint64 getAllocationCount(); // since the program started
+
+// Asserts, when enabled, that nothing was allocated on the heap between its
+// construction and destruction, by any thread
+class NoAllocationScope {
+public:
+  explicit NoAllocationScope(const bool enabled = true)
+      : m_enabled(enabled), m_start(getAllocationCount()) {}
+  ~NoAllocationScope();
+  NoAllocationScope(const NoAllocationScope &) = delete; // no copy
+  NoAllocationScope &
+  operator=(const NoAllocationScope &) = delete; // no copy-assignment
+
+private:
+  bool m_enabled;
+  Uint64 m_start;
+};
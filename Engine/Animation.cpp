@@ -1,30 +1,35 @@
 #include "Components.h"
+#include <algorithm>
 
 // FRAME START
-Frame::Frame(SDL_Texture *texture, const SDL_Rect &source,
+Frame::Frame(const TextureHandle &texture, const SDL_Rect &source,
              const bool queryTexture)
     : m_texture(texture), m_src(source) {
-  if (queryTexture) {
-    SDL_QueryTexture(m_texture, nullptr, nullptr, &m_src.w, &m_src.h);
-  }
+  updateTextureSource(queryTexture);
 }
 
-void Frame::render(SDL_Renderer *renderer, const SDL_Rect &destination) {
-  SDL_RenderCopy(renderer, m_texture, &m_src, &destination);
+void Frame::render(RenderSnapshot &snapshot, const Rectf &previous,
+                   const Rectf &current) const {
+  snapshot.addSprite(m_texture.getSlot(), m_textureSrc, previous, current);
 }
 
-void Frame::setTexture(SDL_Texture *texture, const bool queryTexture) {
+void Frame::setTexture(const TextureHandle &texture,
+                       const bool queryTexture) {
   m_texture = texture;
-  if (queryTexture) {
-    SDL_QueryTexture(m_texture, nullptr, nullptr, &m_src.w, &m_src.h);
-  }
+  updateTextureSource(queryTexture);
 }
 
 void Frame::setSource(const SDL_Rect &source, const bool queryTexture) {
   m_src = source;
+  updateTextureSource(queryTexture);
+}
+
+void Frame::updateTextureSource(const bool queryTexture) {
+  const SDL_Rect image = m_texture.getRect();
   if (queryTexture) {
-    SDL_QueryTexture(m_texture, nullptr, nullptr, &m_src.w, &m_src.h);
+    m_src = {0, 0, image.w, image.h};
   }
+  m_textureSrc = {image.x + m_src.x, image.y + m_src.y, m_src.w, m_src.h};
 }
 // FRAME END
 
@@ -32,54 +37,79 @@ void Frame::setSource(const SDL_Rect &source, const bool queryTexture) {
 AnimationFrame::AnimationFrame(const Frame &frame, const Uint32 ticks)
     : m_frame(frame), m_ticks(ticks) {}
 
-AnimationFrame::AnimationFrame(SDL_Texture *texture, const SDL_Rect &source,
-                               const Uint32 &ticks, const bool queryTexture)
+AnimationFrame::AnimationFrame(const TextureHandle &texture,
+                               const SDL_Rect &source, const Uint32 &ticks,
+                               const bool queryTexture)
     : AnimationFrame(Frame(texture, source, queryTexture), ticks) {}
 
-void AnimationFrame::render(SDL_Renderer *renderer,
-                            const SDL_Rect &destination) {
-  m_frame.render(renderer, destination);
+void AnimationFrame::render(RenderSnapshot &snapshot, const Rectf &previous,
+                            const Rectf &current) const {
+  m_frame.render(snapshot, previous, current);
 }
 // ANIMATION FRAME END
 
-// ANIMATION START
-Animation::Animation(const std::vector<AnimationFrame> &animation)
-    : m_frames(animation), m_nFrames(animation.size()) {}
-
-void Animation::addFrame(const AnimationFrame &frame) {
-  m_frames.push_back(frame);
-  m_nFrames = m_frames.size();
+// ANIMATION CLIP START
+AnimationClip::AnimationClip(const std::vector<AnimationFrame> &frames)
+    : m_frames(frames) {
+  m_frameEnds.reserve(m_frames.size());
+  for (const auto &frame : m_frames) {
+    m_totalTicks += frame.getTicks();
+    m_frameEnds.push_back(m_totalTicks);
+  }
 }
 
-void Animation::addFrames(const std::vector<AnimationFrame> &frames) {
-  for (const auto &frame : frames) {
-    addFrame(frame);
+void AnimationClip::render(RenderSnapshot &snapshot, const Rectf &previous,
+                           const Rectf &current,
+                           const unsigned int frame) const {
+  if (frame >= m_frames.size()) {
+    return;
   }
+  m_frames[frame].render(snapshot, previous, current);
 }
 
-void Animation::render(SDL_Renderer *renderer, const SDL_Rect &destination) {
-  if (m_frames.empty()) {
-    return;
+void AnimationClip::renderAt(RenderSnapshot &snapshot, const Rectf &previous,
+                             const Rectf &current,
+                             const Uint32 &elapsed) const {
+  render(snapshot, previous, current, getFrameAt(elapsed));
+}
+
+unsigned int AnimationClip::getFrameAt(const Uint32 &elapsed) const {
+  if (m_totalTicks == 0) {
+    return 0;
   }
-  m_frames[m_currFrame].render(renderer, destination);
+  // First frame ending after the time into the current loop
+  const auto end = std::upper_bound(m_frameEnds.begin(), m_frameEnds.end(),
+                                    elapsed % m_totalTicks);
+  return unsigned(end - m_frameEnds.begin());
+}
+// ANIMATION CLIP END
+
+// ANIMATION LIBRARY START
+AnimationClipId
+AnimationLibrary::addClip(const std::vector<AnimationFrame> &frames) {
+  m_clips.emplace_back(frames);
+  return AnimationClipId(m_clips.size() - 1);
 }
+// ANIMATION LIBRARY END
 
-void Animation::update(const Uint32 &dt) {
-  m_currTicks += dt;
-  if (m_frames.empty()) {
+// ANIMATION START
+Animation::Animation(const AnimationClip &clip, const Uint32 &start)
+    : m_clip(&clip), m_start(start) {}
+
+void Animation::setClip(const AnimationClip &clip, const Uint32 &start) {
+  m_clip = &clip;
+  m_start = start;
+}
+
+void Animation::render(RenderSnapshot &snapshot, const Rectf &previous,
+                       const Rectf &current, const Uint32 &time) const {
+  if (!m_clip) {
     return;
   }
-  if (m_currTicks >= m_frames[m_currFrame].getTicks()) {
-    m_currTicks %= m_frames[m_currFrame].getTicks();
-    ++m_currFrame;
-    if (m_currFrame == m_nFrames) {
-      m_currFrame = 0;
-    }
-  }
+  m_clip->render(snapshot, previous, current, getFrame(time));
 }
 
-void Animation::reset() {
-  m_currTicks = 0;
-  m_currFrame = 0;
+unsigned int Animation::getFrame(const Uint32 &time) const {
+  return m_clip ? m_clip->getFrameAt(time - m_start) : 0;
 }
 // ANIMATION END
@@ -0,0 +1,63 @@
+#include "AssetManifest.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// ASSET MANIFEST START
+bool AssetManifest::load(const std::string &filePath) {
+  std::ifstream file(filePath);
+  if (!file) {
+    std::cout << "Couldn't open asset manifest " << filePath << std::endl;
+    return false;
+  }
+
+  std::string line;
+  unsigned int lineNumber = 0;
+  while (std::getline(file, line)) {
+    ++lineNumber;
+    std::istringstream entry(line.substr(0, line.find('#')));
+    std::string kind;
+    if (!(entry >> kind)) {
+      continue; // blank or comment
+    }
+
+    bool valid = false;
+    if (kind == "image") {
+      std::string image;
+      valid = bool(entry >> image);
+      if (valid) {
+        addImage(image);
+      }
+    } else if (kind == "clip") {
+      AssetClip clip;
+      valid = bool(entry >> clip.name);
+      if (valid) {
+        addClip(clip);
+      }
+    } else if (kind == "frame") {
+      AssetFrame frame;
+      valid = !m_clips.empty() &&
+              bool(entry >> frame.image >> frame.source.x >> frame.source.y >>
+                   frame.source.w >> frame.source.h >> frame.ticks);
+      if (valid) {
+        m_clips.back().frames.push_back(frame);
+      }
+    }
+    if (!valid) {
+      std::cout << filePath << ":" << lineNumber << ": invalid entry"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+const AssetClip *AssetManifest::findClip(const std::string &name) const {
+  for (const auto &clip : m_clips) {
+    if (clip.name == name) {
+      return &clip;
+    }
+  }
+  return nullptr;
+}
+// ASSET MANIFEST END
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+// A frame of a clip, cut from an image. An empty source covers the whole
+// image.
+struct AssetFrame {
+  std::string image;
+  SDL_Rect source;
+  Uint32 ticks;
+};
+
+struct AssetClip {
+  std::string name;
+  std::vector<AssetFrame> frames;
+};
+
+// Images and clips of the game. Read from a text manifest by the pack tool,
+// or from a baked asset pack at runtime. Text manifests hold one entry per
+// line, '#' starting a comment:
+//   image <path>
+//   clip <name>
+//   frame <image path> <x> <y> <w> <h> <ticks>
+// Frames belong to the last clip declared before them.
+class AssetManifest {
+public:
+  AssetManifest() = default;
+
+public:
+  bool load(const std::string &filePath);
+  void addImage(const std::string &image) { m_images.push_back(image); }
+  void addClip(const AssetClip &clip) { m_clips.push_back(clip); }
+  const AssetClip *findClip(const std::string &name) const;
+
+  // Getters
+  const std::vector<std::string> &getImages() const { return m_images; }
+  const std::vector<AssetClip> &getClips() const { return m_clips; }
+
+private:
+  std::vector<std::string> m_images;
+  std::vector<AssetClip> m_clips;
+};
@@ -0,0 +1,163 @@
+#include "AssetPack.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ASSET PACK START
+bool AssetPack::open(const std::string &filePath) {
+  close();
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  m_file = file;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    close();
+    return false;
+  }
+  m_size = std::size_t(size.QuadPart);
+  m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!m_mapping) {
+    close();
+    return false;
+  }
+  m_data = static_cast<const Uint8 *>(
+      MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+  m_file = ::open(filePath.c_str(), O_RDONLY);
+  if (m_file < 0) {
+    return false;
+  }
+  struct stat info;
+  if (fstat(m_file, &info) != 0 || info.st_size == 0) {
+    close();
+    return false;
+  }
+  m_size = std::size_t(info.st_size);
+  void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+  m_data = data == MAP_FAILED ? nullptr : static_cast<const Uint8 *>(data);
+#endif
+  if (!m_data) {
+    close();
+    return false;
+  }
+
+  // Pointers into the tables are only derived once they are known to fit
+  bool valid = validateTables();
+  if (valid) {
+    m_header = reinterpret_cast<const PackHeader *>(m_data);
+    m_images = reinterpret_cast<const PackImage *>(m_header + 1);
+    m_clips =
+        reinterpret_cast<const PackClip *>(m_images + m_header->nImages);
+    m_frames = reinterpret_cast<const PackFrame *>(m_clips + m_header->nClips);
+    valid = validate();
+  }
+  if (!valid) {
+    std::cout << "Invalid asset pack " << filePath << std::endl;
+    close();
+    return false;
+  }
+  return true;
+}
+
+void AssetPack::close() {
+#ifdef _WIN32
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_mapping) {
+    CloseHandle(m_mapping);
+  }
+  if (m_file) {
+    CloseHandle(m_file);
+  }
+  m_mapping = nullptr;
+  m_file = nullptr;
+#else
+  if (m_data) {
+    munmap(const_cast<Uint8 *>(m_data), m_size);
+  }
+  if (m_file >= 0) {
+    ::close(m_file);
+  }
+  m_file = -1;
+#endif
+  m_data = nullptr;
+  m_size = 0;
+  m_header = nullptr;
+  m_images = nullptr;
+  m_clips = nullptr;
+  m_frames = nullptr;
+}
+
+void AssetPack::readManifest(AssetManifest &manifest) const {
+  for (Uint32 i = 0; i < m_header->nImages; ++i) {
+    manifest.addImage(m_images[i].name);
+  }
+  for (Uint32 i = 0; i < m_header->nClips; ++i) {
+    AssetClip clip;
+    clip.name = m_clips[i].name;
+    for (Uint32 j = 0; j < m_clips[i].nFrames; ++j) {
+      const PackFrame &frame = m_frames[m_clips[i].firstFrame + j];
+      clip.frames.push_back({m_images[frame.image].name,
+                             {frame.x, frame.y, frame.w, frame.h},
+                             frame.ticks});
+    }
+    manifest.addClip(clip);
+  }
+}
+
+bool AssetPack::validateTables() const {
+  // The header must fit before reading it
+  if (m_size < sizeof(PackHeader)) {
+    return false;
+  }
+  const PackHeader *header = reinterpret_cast<const PackHeader *>(m_data);
+  if (std::memcmp(header->magic, PackMagic, sizeof(PackMagic)) != 0 ||
+      header->version != PackVersion) {
+    return false;
+  }
+  const Uint64 tables = sizeof(PackHeader) +
+                        Uint64(header->nImages) * sizeof(PackImage) +
+                        Uint64(header->nClips) * sizeof(PackClip) +
+                        Uint64(header->nFrames) * sizeof(PackFrame);
+  return tables <= m_size;
+}
+
+bool AssetPack::validate() const {
+  for (Uint32 i = 0; i < m_header->nImages; ++i) {
+    const PackImage &image = m_images[i];
+    if (image.name[PackNameLength - 1] != '\0' ||
+        image.pitch < Uint64(image.width) * 4 || image.offset > m_size ||
+        Uint64(image.pitch) * image.height > m_size - image.offset) {
+      return false;
+    }
+  }
+  for (Uint32 i = 0; i < m_header->nClips; ++i) {
+    const PackClip &clip = m_clips[i];
+    if (clip.name[PackNameLength - 1] != '\0' ||
+        Uint64(clip.firstFrame) + clip.nFrames > m_header->nFrames) {
+      return false;
+    }
+  }
+  for (Uint32 i = 0; i < m_header->nFrames; ++i) {
+    if (m_frames[i].image >= m_header->nImages) {
+      return false;
+    }
+  }
+  return true;
+}
+// ASSET PACK END
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AssetManifest.h"
+#include <SDL2/SDL.h>
+#include <string>
+
+// On-disk layout of a baked asset pack, in native byte order:
+//   PackHeader
+//   PackImage[nImages]
+//   PackClip[nClips]
+//   PackFrame[nFrames]
+//   RGBA32 pixels of each image, every image starting PackAlignment aligned
+const char PackMagic[4] = {'S', 'T', 'G', 'P'};
+const Uint32 PackVersion = 1;
+const std::size_t PackNameLength = 64; // including the terminating zero
+const std::size_t PackAlignment = 16;
+
+struct PackHeader {
+  char magic[4];
+  Uint32 version;
+  Uint32 nImages;
+  Uint32 nClips;
+  Uint32 nFrames;
+  Uint32 reserved;
+};
+
+struct PackImage {
+  char name[PackNameLength];
+  Uint32 width;
+  Uint32 height;
+  Uint32 pitch;
+  Uint32 reserved;
+  Uint64 offset; // of the pixels, from the start of the file
+};
+
+struct PackClip {
+  char name[PackNameLength];
+  Uint32 firstFrame;
+  Uint32 nFrames;
+};
+
+// Sources are already resolved, whole-image frames hold the image size
+struct PackFrame {
+  Uint32 image;
+  Sint32 x, y, w, h;
+  Uint32 ticks;
+};
+
+// Read-only memory mapping of a pack file. Pixels are used straight from
+// the mapping, nothing is copied or decoded.
+class AssetPack {
+public:
+  AssetPack() = default;
+  ~AssetPack() { close(); }
+  AssetPack(const AssetPack &) = delete;            // no copy
+  AssetPack &operator=(const AssetPack &) = delete; // no copy-assignment
+
+public:
+  bool open(const std::string &filePath);
+  void close();
+  void readManifest(AssetManifest &manifest) const;
+
+  // Getters
+  bool isOpen() const { return m_data != nullptr; }
+  Uint32 getImageCount() const { return m_header->nImages; }
+  const PackImage &getImage(const Uint32 image) const {
+    return m_images[image];
+  }
+  const void *getPixels(const Uint32 image) const {
+    return m_data + m_images[image].offset;
+  }
+
+private:
+  bool validateTables() const;
+  bool validate() const;
+
+private:
+  const Uint8 *m_data = nullptr;
+  std::size_t m_size = 0;
+  const PackHeader *m_header = nullptr;
+  const PackImage *m_images = nullptr;
+  const PackClip *m_clips = nullptr;
+  const PackFrame *m_frames = nullptr;
+#ifdef _WIN32
+  void *m_file = nullptr;
+  void *m_mapping = nullptr;
+#else
+  int m_file = -1;
+#endif
+};
@@ -0,0 +1,85 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+
+// SKYLINE PACKER START
+SkylinePacker::SkylinePacker(const int width, const int height)
+    : m_width(width), m_height(height) {
+  clear();
+}
+
+bool SkylinePacker::insert(const int w, const int h, SDL_Rect &rect) {
+  std::size_t best = m_skyline.size();
+  int bestBottom = m_height + 1;
+  int bestWidth = m_width + 1;
+  for (std::size_t i = 0; i < m_skyline.size(); ++i) {
+    int y;
+    if (!fits(i, w, h, y)) {
+      continue;
+    }
+    if (y + h < bestBottom ||
+        (y + h == bestBottom && m_skyline[i].width < bestWidth)) {
+      best = i;
+      bestBottom = y + h;
+      bestWidth = m_skyline[i].width;
+      rect = {m_skyline[i].x, y, w, h};
+    }
+  }
+  if (best == m_skyline.size()) {
+    return false;
+  }
+  addSegment(best, rect);
+  return true;
+}
+
+void SkylinePacker::clear() {
+  m_skyline.clear();
+  m_skyline.push_back({0, 0, m_width});
+}
+
+bool SkylinePacker::fits(const std::size_t segment, const int w, const int h,
+                         int &y) const {
+  if (m_skyline[segment].x + w > m_width) {
+    return false;
+  }
+  // The rect rests on the highest segment it spans
+  y = 0;
+  int remaining = w;
+  for (std::size_t i = segment; remaining > 0; ++i) {
+    if (i == m_skyline.size()) {
+      return false;
+    }
+    y = std::max(y, m_skyline[i].y);
+    remaining -= m_skyline[i].width;
+  }
+  return y + h <= m_height;
+}
+
+void SkylinePacker::addSegment(const std::size_t segment,
+                               const SDL_Rect &rect) {
+  m_skyline.insert(m_skyline.begin() + segment,
+                   {rect.x, rect.y + rect.h, rect.w});
+
+  // Trim or drop the segments now hidden below the new one
+  const int right = rect.x + rect.w;
+  std::size_t i = segment + 1;
+  while (i < m_skyline.size() && m_skyline[i].x < right) {
+    const int overlap = right - m_skyline[i].x;
+    if (overlap < m_skyline[i].width) {
+      m_skyline[i].x += overlap;
+      m_skyline[i].width -= overlap;
+      break;
+    }
+    m_skyline.erase(m_skyline.begin() + i);
+  }
+
+  // Merge neighbours at the same height
+  for (std::size_t j = 0; j + 1 < m_skyline.size();) {
+    if (m_skyline[j].y == m_skyline[j + 1].y) {
+      m_skyline[j].width += m_skyline[j + 1].width;
+      m_skyline.erase(m_skyline.begin() + j + 1);
+    } else {
+      ++j;
+    }
+  }
+}
+// SKYLINE PACKER END
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Bottom-left skyline packer. Keeps the top outline of the packed rects as a
+// list of horizontal segments and places each new rect where its bottom
+// edge ends up lowest, breaking ties with the narrowest segment.
+class SkylinePacker {
+public:
+  SkylinePacker(const int width, const int height);
+
+public:
+  // Finds a spot for a w x h rect, false when the atlas is full
+  bool insert(const int w, const int h, SDL_Rect &rect);
+  void clear();
+
+  // Getters
+  int getWidth() const { return m_width; }
+  int getHeight() const { return m_height; }
+
+private:
+  struct Segment {
+    int x, y, width;
+  };
+
+  bool fits(const std::size_t segment, const int w, const int h,
+            int &y) const;
+  void addSegment(const std::size_t segment, const SDL_Rect &rect);
+
+private:
+  int m_width;
+  int m_height;
+  std::vector<Segment> m_skyline;
+};
@@ -0,0 +1,338 @@
+#include "Collision.h"
+#include "../Game/Definitions.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COLLISION_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// OVERLAP KERNEL START
+std::size_t overlapBatchScalar(const Rectf &target, const float *x,
+                               const float *y, const float *w, const float *h,
+                               const std::size_t count, unsigned int *hits) {
+  std::size_t nHits = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (overlaps(target, {x[i], y[i], w[i], h[i]})) {
+      hits[nHits++] = i;
+    }
+  }
+  return nHits;
+}
+
+#ifdef COLLISION_X86_KERNELS
+static std::size_t writeHits(unsigned int mask, const std::size_t base,
+                             unsigned int *hits) {
+  std::size_t nHits = 0;
+  while (mask != 0) {
+    hits[nHits++] = base + __builtin_ctz(mask);
+    mask &= mask - 1;
+  }
+  return nHits;
+}
+
+__attribute__((target("sse2"))) static std::size_t
+overlapBatchSse(const Rectf &target, const float *x, const float *y,
+                const float *w, const float *h, const std::size_t count,
+                unsigned int *hits) {
+  const __m128 left = _mm_set1_ps(target.x);
+  const __m128 right = _mm_set1_ps(target.x + target.w);
+  const __m128 top = _mm_set1_ps(target.y);
+  const __m128 bottom = _mm_set1_ps(target.y + target.h);
+
+  std::size_t nHits = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128 bx = _mm_loadu_ps(x + i);
+    const __m128 by = _mm_loadu_ps(y + i);
+    const __m128 bRight = _mm_add_ps(bx, _mm_loadu_ps(w + i));
+    const __m128 bBottom = _mm_add_ps(by, _mm_loadu_ps(h + i));
+    const __m128 inX =
+        _mm_and_ps(_mm_cmplt_ps(left, bRight), _mm_cmplt_ps(bx, right));
+    const __m128 inY =
+        _mm_and_ps(_mm_cmplt_ps(top, bBottom), _mm_cmplt_ps(by, bottom));
+    const int mask = _mm_movemask_ps(_mm_and_ps(inX, inY));
+    nHits += writeHits(mask, i, hits + nHits);
+  }
+  const std::size_t tail =
+      overlapBatchScalar(target, x + i, y + i, w + i, h + i, count - i,
+                         hits + nHits);
+  for (std::size_t k = nHits; k < nHits + tail; ++k) {
+    hits[k] += i;
+  }
+  return nHits + tail;
+}
+
+__attribute__((target("avx2"))) static std::size_t
+overlapBatchAvx2(const Rectf &target, const float *x, const float *y,
+                 const float *w, const float *h, const std::size_t count,
+                 unsigned int *hits) {
+  const __m256 left = _mm256_set1_ps(target.x);
+  const __m256 right = _mm256_set1_ps(target.x + target.w);
+  const __m256 top = _mm256_set1_ps(target.y);
+  const __m256 bottom = _mm256_set1_ps(target.y + target.h);
+
+  std::size_t nHits = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256 bx = _mm256_loadu_ps(x + i);
+    const __m256 by = _mm256_loadu_ps(y + i);
+    const __m256 bRight = _mm256_add_ps(bx, _mm256_loadu_ps(w + i));
+    const __m256 bBottom = _mm256_add_ps(by, _mm256_loadu_ps(h + i));
+    const __m256 inX =
+        _mm256_and_ps(_mm256_cmp_ps(left, bRight, _CMP_LT_OQ),
+                      _mm256_cmp_ps(bx, right, _CMP_LT_OQ));
+    const __m256 inY =
+        _mm256_and_ps(_mm256_cmp_ps(top, bBottom, _CMP_LT_OQ),
+                      _mm256_cmp_ps(by, bottom, _CMP_LT_OQ));
+    const int mask = _mm256_movemask_ps(_mm256_and_ps(inX, inY));
+    nHits += writeHits(mask, i, hits + nHits);
+  }
+  const std::size_t tail =
+      overlapBatchSse(target, x + i, y + i, w + i, h + i, count - i,
+                      hits + nHits);
+  for (std::size_t k = nHits; k < nHits + tail; ++k) {
+    hits[k] += i;
+  }
+  return nHits + tail;
+}
+#endif
+
+std::size_t overlapBatch(const Rectf &target, const float *x, const float *y,
+                         const float *w, const float *h,
+                         const std::size_t count, unsigned int *hits) {
+#ifdef COLLISION_X86_KERNELS
+  static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+  if (hasAvx2) {
+    return overlapBatchAvx2(target, x, y, w, h, count, hits);
+  }
+  return overlapBatchSse(target, x, y, w, h, count, hits);
+#else
+  return overlapBatchScalar(target, x, y, w, h, count, hits);
+#endif
+}
+// OVERLAP KERNEL END
+
+// SWEPT TEST START
+// Open interval of the tick during which two segments overlap, the first
+// one moving by velocity relative to the second
+static void sweepAxis(const float a, const float aSize, const float b,
+                      const float bSize, const float velocity, float &enter,
+                      float &exit) {
+  const float infinity = std::numeric_limits<float>::infinity();
+  if (velocity == 0.0f) {
+    const bool inside = a < b + bSize && b < a + aSize;
+    enter = inside ? -infinity : infinity;
+    exit = inside ? infinity : -infinity;
+    return;
+  }
+  const float touch = (b - (a + aSize)) / velocity;
+  const float leave = (b + bSize - a) / velocity;
+  enter = std::min(touch, leave);
+  exit = std::max(touch, leave);
+}
+
+bool sweptOverlap(const Rectf &aPrevious, const Rectf &aCurrent,
+                  const Rectf &bPrevious, const Rectf &bCurrent,
+                  float &timeOfImpact) {
+  // Move a relative to b, so b stays where it started
+  const float vx = (aCurrent.x - aPrevious.x) - (bCurrent.x - bPrevious.x);
+  const float vy = (aCurrent.y - aPrevious.y) - (bCurrent.y - bPrevious.y);
+  float enterX, exitX, enterY, exitY;
+  sweepAxis(aPrevious.x, aCurrent.w, bPrevious.x, bCurrent.w, vx, enterX,
+            exitX);
+  sweepAxis(aPrevious.y, aCurrent.h, bPrevious.y, bCurrent.h, vy, enterY,
+            exitY);
+  const float enter = std::max(std::max(enterX, enterY), 0.0f);
+  const float exit = std::min(std::min(exitX, exitY), 1.0f);
+  if (enter >= exit) {
+    return false;
+  }
+  timeOfImpact = enter;
+  return true;
+}
+// SWEPT TEST END
+
+// SPATIAL HASH GRID START
+SpatialHashGrid::SpatialHashGrid(const float cellSize)
+    : m_cellSize(cellSize) {}
+
+void SpatialHashGrid::clear() {
+  m_colliders.clear();
+  m_entries.clear();
+}
+
+unsigned int SpatialHashGrid::addCollider(const Rectf &rect,
+                                          const Uint32 layer,
+                                          const Uint32 mask,
+                                          const unsigned int owner) {
+  return addCollider(rect, rect, layer, mask, owner);
+}
+
+unsigned int SpatialHashGrid::addCollider(const Rectf &previous,
+                                          const Rectf &current,
+                                          const Uint32 layer,
+                                          const Uint32 mask,
+                                          const unsigned int owner) {
+  const unsigned int index = m_colliders.size();
+  const Rectf rect = sweptBounds(previous, current);
+  m_colliders.push_back({rect, previous, current, layer, mask, owner});
+
+  const int x0 = toCell(rect.x);
+  const int y0 = toCell(rect.y);
+  const int x1 = toCell(rect.x + rect.w);
+  const int y1 = toCell(rect.y + rect.h);
+  for (int cy = y0; cy <= y1; ++cy) {
+    for (int cx = x0; cx <= x1; ++cx) {
+      m_entries.push_back({cellKey(cx, cy), layer, mask, index});
+    }
+  }
+  return index;
+}
+
+void SpatialHashGrid::findPairs(std::vector<CollisionPair> &pairs,
+                                JobSystem *jobs,
+                                std::pmr::memory_resource *scratch) {
+  pairs.clear();
+  std::sort(m_entries.begin(), m_entries.end(),
+            [](const CellEntry &a, const CellEntry &b) {
+              if (a.cell != b.cell) {
+                return a.cell < b.cell;
+              }
+              if (a.layer != b.layer) {
+                return a.layer < b.layer;
+              }
+              if (a.mask != b.mask) {
+                return a.mask < b.mask;
+              }
+              return a.collider < b.collider;
+            });
+
+  m_x.resize(m_entries.size());
+  m_y.resize(m_entries.size());
+  m_w.resize(m_entries.size());
+  m_h.resize(m_entries.size());
+  m_cells.clear();
+  std::size_t largestCell = 0;
+  for (std::size_t i = 0; i < m_entries.size(); ++i) {
+    const Rectf &rect = m_colliders[m_entries[i].collider].rect;
+    m_x[i] = rect.x;
+    m_y[i] = rect.y;
+    m_w[i] = rect.w;
+    m_h[i] = rect.h;
+    if (i == 0 || m_entries[i].cell != m_entries[i - 1].cell) {
+      if (!m_cells.empty()) {
+        largestCell = std::max(largestCell, i - m_cells.back());
+      }
+      m_cells.push_back(i);
+    }
+  }
+  if (!m_cells.empty()) {
+    largestCell = std::max(largestCell, m_entries.size() - m_cells.back());
+  }
+  m_cells.push_back(m_entries.size());
+
+  // Cells are split in chunks, each chunk writes its own pairs and the
+  // chunks are merged in order, so the result does not depend on how the
+  // chunks were scheduled
+  const std::size_t nCells = m_cells.size() - 1;
+  const std::size_t chunkSize = Global::Jobs::CollisionChunkSize;
+  const std::size_t nChunks = JobSystem::chunkCount(nCells, chunkSize);
+  std::pmr::memory_resource *memory =
+      scratch ? scratch : std::pmr::get_default_resource();
+  std::pmr::vector<ChunkScratch> chunks(memory);
+  chunks.reserve(nChunks);
+  for (std::size_t i = 0; i < nChunks; ++i) {
+    chunks.emplace_back(memory);
+  }
+  parallelFor(jobs, nCells, chunkSize,
+              [&](const std::size_t begin, const std::size_t end) {
+                ChunkScratch &chunk = chunks[begin / chunkSize];
+                chunk.hits.resize(largestCell);
+                for (std::size_t cell = begin; cell < end; ++cell) {
+                  findCellPairs(m_cells[cell], m_cells[cell + 1], chunk);
+                }
+              });
+
+  pairs.clear();
+  for (const auto &chunk : chunks) {
+    pairs.insert(pairs.end(), chunk.pairs.begin(), chunk.pairs.end());
+  }
+}
+
+void SpatialHashGrid::findCellPairs(const std::size_t begin,
+                                    const std::size_t end,
+                                    ChunkScratch &chunk) const {
+  // Walk the groups of colliders sharing layer and mask, testing each one
+  // against itself and the following groups of the cell
+  std::size_t group = begin;
+  while (group < end) {
+    const std::size_t groupEnd = findGroupEnd(group);
+    std::size_t other = group;
+    while (other < end) {
+      const std::size_t otherEnd = findGroupEnd(other);
+      if (accepts(m_entries[group], m_entries[other])) {
+        testGroups(group, groupEnd, other, otherEnd, chunk);
+      }
+      other = otherEnd;
+    }
+    group = groupEnd;
+  }
+}
+
+std::size_t SpatialHashGrid::findGroupEnd(const std::size_t group) const {
+  const CellEntry &first = m_entries[group];
+  std::size_t end = group + 1;
+  while (end < m_entries.size() && m_entries[end].cell == first.cell &&
+         m_entries[end].layer == first.layer &&
+         m_entries[end].mask == first.mask) {
+    ++end;
+  }
+  return end;
+}
+
+void SpatialHashGrid::testGroups(const std::size_t group,
+                                 const std::size_t groupEnd,
+                                 const std::size_t other,
+                                 const std::size_t otherEnd,
+                                 ChunkScratch &chunk) const {
+  const Uint64 cell = m_entries[group].cell;
+  for (std::size_t i = group; i < groupEnd; ++i) {
+    const std::size_t begin = group == other ? i + 1 : other;
+    if (begin >= otherEnd) {
+      continue;
+    }
+    const Rectf &rect = m_colliders[m_entries[i].collider].rect;
+    const std::size_t nHits =
+        overlapBatch(rect, &m_x[begin], &m_y[begin], &m_w[begin],
+                     &m_h[begin], otherEnd - begin, chunk.hits.data());
+    for (std::size_t k = 0; k < nHits; ++k) {
+      const std::size_t j = begin + chunk.hits[k];
+      // Pairs sharing several cells are only reported by the cell holding
+      // the top-left corner of their intersection
+      const int cx = toCell(std::max(m_x[i], m_x[j]));
+      const int cy = toCell(std::max(m_y[i], m_y[j]));
+      if (cellKey(cx, cy) != cell) {
+        continue;
+      }
+      const unsigned int a = m_entries[i].collider;
+      const unsigned int b = m_entries[j].collider;
+      chunk.pairs.push_back({std::min(a, b), std::max(a, b)});
+    }
+  }
+}
+
+int SpatialHashGrid::toCell(const float coord) const {
+  return int(std::floor(coord / m_cellSize));
+}
+
+Uint64 SpatialHashGrid::cellKey(const int cx, const int cy) const {
+  return (Uint64(Uint32(cx)) << 32) | Uint64(Uint32(cy));
+}
+
+bool SpatialHashGrid::accepts(const CellEntry &a, const CellEntry &b) const {
+  return (a.mask & b.layer) != 0 || (b.mask & a.layer) != 0;
+}
+// SPATIAL HASH GRID END
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Components_forward.h"
+#include "JobSystem.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <memory_resource>
+#include <vector>
+
+// Collision layers, combined as bit flags in collider masks
+enum CollisionLayer : Uint32 {
+  NoLayer = 0,
+  PlayerLayer = 1 << 0,
+  EnemyLayer = 1 << 1,
+  PlayerBulletLayer = 1 << 2,
+  EnemyBulletLayer = 1 << 3,
+  AllLayers = 0xFFFFFFFF
+};
+
+// True if both rectangles share some area, touching edges do not count
+inline bool overlaps(const Rectf &a, const Rectf &b) {
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h &&
+         b.y < a.y + a.h;
+}
+
+// Tests one target against a batch of rectangles stored as separate
+// coordinate arrays. Writes the indices of the overlapping rectangles to
+// hits, in increasing order, and returns how many were written. Uses AVX2 or
+// SSE when the CPU supports them.
+std::size_t overlapBatch(const Rectf &target, const float *x, const float *y,
+                         const float *w, const float *h,
+                         const std::size_t count, unsigned int *hits);
+std::size_t overlapBatchScalar(const Rectf &target, const float *x,
+                               const float *y, const float *w, const float *h,
+                               const std::size_t count, unsigned int *hits);
+
+// Smallest rectangle holding both
+inline Rectf sweptBounds(const Rectf &previous, const Rectf &current) {
+  const float x = std::min(previous.x, current.x);
+  const float y = std::min(previous.y, current.y);
+  return {x, y, std::max(previous.x + previous.w, current.x + current.w) - x,
+          std::max(previous.y + previous.h, current.y + current.h) - y};
+}
+
+// Continuous test of two rectangles moving in a straight line during a
+// tick, from previous to current. On a hit, writes the fraction of the tick,
+// in [0, 1), at which they start to overlap. Rectangles overlapping at the
+// start of the tick hit at 0.
+bool sweptOverlap(const Rectf &aPrevious, const Rectf &aCurrent,
+                  const Rectf &bPrevious, const Rectf &bCurrent,
+                  float &timeOfImpact);
+
+struct Collider {
+  Rectf rect;          // swept over the tick, used by the broad-phase
+  Rectf previous;      // at the start of the tick
+  Rectf current;       // at the end of the tick
+  Uint32 layer;        // layers this collider belongs to
+  Uint32 mask;         // layers this collider wants to hit
+  unsigned int owner;  // index of the object in its own container
+};
+
+// Indices of two overlapping colliders, first < second
+struct CollisionPair {
+  unsigned int first;
+  unsigned int second;
+};
+
+// Colliding pair and the fraction of the tick at which they met
+struct CollisionImpact {
+  float time;
+  unsigned int first;
+  unsigned int second;
+};
+
+// Uniform grid broad-phase. Colliders are added every tick with where they were
+// and are, each one is registered in every cell its sweep touches and the cells
+// are then sorted so that only colliders sharing a cell are tested against each
+// other. Inside a cell, colliders with the same layer and mask are grouped and
+// each collider is tested against whole groups with overlapBatch. Storage is
+// reused between ticks and per job scratch comes from the given memory
+// resource, so steady state ticks given a tick arena do not allocate.
+class SpatialHashGrid {
+public:
+  SpatialHashGrid() = default;
+  SpatialHashGrid(const float cellSize);
+
+public:
+  void clear();
+  unsigned int addCollider(const Rectf &rect, const Uint32 layer,
+                           const Uint32 mask, const unsigned int owner);
+  unsigned int addCollider(const Rectf &previous, const Rectf &current,
+                           const Uint32 layer, const Uint32 mask,
+                           const unsigned int owner);
+  void findPairs(std::vector<CollisionPair> &pairs, JobSystem *jobs = nullptr,
+                 std::pmr::memory_resource *scratch = nullptr);
+
+  // Setters
+  void setCellSize(const float cellSize) { m_cellSize = cellSize; }
+
+  // Getters
+  const Collider &getCollider(const unsigned int index) const {
+    return m_colliders[index];
+  }
+  std::size_t size() const { return m_colliders.size(); }
+
+private:
+  struct CellEntry {
+    Uint64 cell;
+    Uint32 layer;
+    Uint32 mask;
+    unsigned int collider;
+  };
+
+  // Per job output and overlapBatch buffer
+  struct ChunkScratch {
+    explicit ChunkScratch(std::pmr::memory_resource *memory)
+        : pairs(memory), hits(memory) {}
+
+    std::pmr::vector<CollisionPair> pairs;
+    std::pmr::vector<unsigned int> hits;
+  };
+
+  void findCellPairs(const std::size_t begin, const std::size_t end,
+                     ChunkScratch &chunk) const;
+  std::size_t findGroupEnd(const std::size_t group) const;
+  void testGroups(const std::size_t group, const std::size_t groupEnd,
+                  const std::size_t other, const std::size_t otherEnd,
+                  ChunkScratch &chunk) const;
+  int toCell(const float coord) const;
+  Uint64 cellKey(const int cx, const int cy) const;
+  bool accepts(const CellEntry &a, const CellEntry &b) const;
+
+private:
+  float m_cellSize = 0.1f;
+  std::vector<Collider> m_colliders;
+  std::vector<CellEntry> m_entries;
+
+  // Sorted entries' rectangles, laid out for overlapBatch
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<float> m_w;
+  std::vector<float> m_h;
+
+  // First entry of every cell, followed by the end of the entries
+  std::vector<std::size_t> m_cells;
+};
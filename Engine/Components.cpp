@@ -1,135 +1,157 @@
 #include "Components.h"
 #include "../Game/Definitions.h"
+#include "Collision.h"
 #include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <numeric>
 
+const SDL_Rect toAbsoluteRect(const Rectf &rect) {
+  int x = int(rect.x * Global::SDL::ScreenWidth);
+  int y = int(rect.y * Global::SDL::ScreenHeight);
+  int w = int(rect.w * Global::SDL::ScreenWidth);
+  int h = int(rect.h * Global::SDL::ScreenHeight);
+  return {x, y, w, h};
+}
+
 // OBJECT STAR
 Object::Object(const Animation &animation, const Rectf &destination,
                const float scale, const ObjState state)
     : m_animation(animation), m_dst(destination), m_state(state) {
   m_dst.w *= scale;
   m_dst.h *= scale;
+  syncDestination();
+  m_prevDst = m_dst;
 }
 
 const SDL_Rect Object::getAbsoluteDestination() const {
-  int x = int(m_dst.x * Global::SDL::ScreenWidth);
-  int y = int(m_dst.y * Global::SDL::ScreenHeight);
-  int w = int(m_dst.w * Global::SDL::ScreenWidth);
-  int h = int(m_dst.h * Global::SDL::ScreenHeight);
-  return {x, y, w, h};
+#ifdef FIXED_POINT_PHYSICS
+  return {toInt(m_fixedDst.x), toInt(m_fixedDst.y), toInt(m_fixedDst.w),
+          toInt(m_fixedDst.h)};
+#else
+  return toAbsoluteRect(m_dst);
+#endif
 }
 
-void Object::render(SDL_Renderer *renderer) {
-  m_animation.render(renderer, getAbsoluteDestination());
+void Object::render(RenderSnapshot &snapshot) {
+  m_animation.render(snapshot, m_prevDst, m_dst, m_clock);
 }
 
-void Object::update(const Uint32 &dt) { m_animation.update(dt); }
+void Object::update(const Uint32 &dt) { advanceClock(dt); }
 
 void Object::scale(const float factor) {
   m_dst.w *= factor;
   m_dst.h *= factor;
+  syncDestination();
+  m_prevDst.w *= factor;
+  m_prevDst.h *= factor;
+}
+
+#ifdef FIXED_POINT_PHYSICS
+void Object::syncDestination() {
+  setFixedDestination(toFixedRect(m_dst));
+}
+
+void Object::setFixedDestination(const FixedRect &dst) {
+  m_fixedDst = dst;
+  m_dst = toNormalizedRect(dst);
+}
+#else
+void Object::syncDestination() {}
+#endif
+
+bool Object::isColiding(const Object &obj) const {
+  return isColiding(obj.getDestination());
 }
 
-bool Object::isColiding(const Object &obj) {
-  return getPosX() <= obj.getPosX() && getPosY() <= obj.getPosY() &&
-         getOppositeX() >= obj.getOppositeX() &&
-         getOppositeY() >= obj.getOppositeY();
+bool Object::isColiding(const Rectf &rect) const {
+  return overlaps(m_dst, rect);
 }
 // OBJECT END
 
 // DYNAMIC OBJECT START
-DynamicObject::DynamicObject(
-    const std::unordered_map<ObjState, Animation> &animations,
-    const Rectf &destination, const float vx, const float vy,
-    const bool gravitySensitive, const float scale, const ObjState state)
+DynamicObject::DynamicObject(const StateAnimations &animations,
+                             const Rectf &destination, const float vx,
+                             const float vy, const bool gravitySensitive,
+                             const float scale, const ObjState state)
     : Object(Animation(), destination, scale, state), m_animations(animations),
       m_vx(vx), m_vy(vy), m_gravitySensitive(gravitySensitive),
-      m_previousState(state) {}
+      m_previousState(state) {
+  syncVelocity();
+}
 
 void DynamicObject::update(const Uint32 &dt) {
-  updatePosX(m_vx * dt);
-  updatePosY(m_vy * dt);
-  if (getOppositeY() >= Global::Game::Floor) {
-    setPosY(Global::Game::Floor - getHeight());
-    m_vy = 0.0f;
-  } else if (m_gravitySensitive) {
-    m_vy += Global::Game::Gravity;
-  }
+  storePreviousDestination();
+  integrate(float(dt));
+  updateAnimation(dt);
+}
 
-  // Update animations
-  if (m_previousState != getState()) {
-    m_animations[getState()].reset();
+#ifdef FIXED_POINT_PHYSICS
+void DynamicObject::integrate(const float dt) {
+  // Event offsets make dt fractional, it gets rounded to the 16.16 grid
+  const Fixed step = toFixed(dt);
+  const Fixed floor = getFixedFloor();
+  FixedRect dst = getFixedDestination();
+  dst.x += fixedMul(m_fixedVx, step);
+  dst.y += fixedMul(m_fixedVy, step);
+  // Only a falling or resting object is stopped by the floor
+  if (dst.y + dst.h >= floor && m_fixedVy >= 0) {
+    dst.y = floor - dst.h;
+    m_fixedVy = 0;
+  } else if (m_gravitySensitive) {
+    m_fixedVy += fixedMul(getFixedGravity(), step);
   }
-  m_animations[getState()].update(dt);
-  m_previousState = getState();
+  setFixedDestination(dst);
+  m_vy = toNormalizedY(m_fixedVy);
 }
 
-void DynamicObject::render(SDL_Renderer *renderer) {
-  m_animations[getState()].render(renderer, getAbsoluteDestination());
+bool DynamicObject::isOnFloor() const {
+  const FixedRect &dst = getFixedDestination();
+  return dst.y + dst.h >= getFixedFloor();
 }
 
-void DynamicObject::addAnimation(const ObjState state,
-                                 const Animation &animation) {
-  m_animations.insert(std::make_pair(state, animation));
+void DynamicObject::syncVelocity() {
+  m_fixedVx = toFixedX(m_vx);
+  m_fixedVy = toFixedY(m_vy);
+  m_vx = toNormalizedX(m_fixedVx);
+  m_vy = toNormalizedY(m_fixedVy);
 }
-// DYNAMIC OBJECT END
-
-// PROJECTILE START
-Projectile::Projectile(
-    const std::unordered_map<ObjState, Animation> &animations,
-    const Rectf &destination, const int damage, const Uint32 &lifeSpan,
-    const float vx, const float vy, const bool gravitySensitive,
-    const float scale, const ObjState state)
-    : DynamicObject(animations, destination, vx, vy, gravitySensitive, scale,
-                    state),
-      m_damage(damage), m_lifeSpan(lifeSpan) {}
-
-void Projectile::update(const Uint32 &dt) {
-  DynamicObject::update(dt);
-  if (m_lifeSpan <= dt) {
-    m_lifeSpan = 0;
-    m_endedLifespan = m_lifeSpan <= 0;
-  } else {
-    m_lifeSpan -= dt;
+#else
+void DynamicObject::integrate(const float dt) {
+  updatePosX(m_vx * dt);
+  updatePosY(m_vy * dt);
+  // Only a falling or resting object is stopped by the floor
+  if (isOnFloor() && m_vy >= 0.0f) {
+    setPosY(Global::Game::Floor - getHeight());
+    m_vy = 0.0f;
+  } else if (m_gravitySensitive) {
+    m_vy += Global::Game::Gravity * dt;
   }
 }
 
-void Projectile::hitted() {
-  m_lifeSpan = 0;
-  m_endedLifespan = true;
+bool DynamicObject::isOnFloor() const {
+  return getOppositeY() >= Global::Game::Floor;
 }
-// PROJECTILE END
 
-// TIMER START
-Timer::Timer() { m_lastTick_ms = SDL_GetTicks(); }
+void DynamicObject::syncVelocity() {}
+#endif
 
-Timer::Timer(const Uint32 interval) : m_interval_ms(interval) {
-  m_lastTick_ms = SDL_GetTicks();
-}
-
-bool Timer::triggered() {
-  Uint32 currentTicks = SDL_GetTicks();
-  if (currentTicks - m_lastTick_ms > m_interval_ms) {
-    m_lastTick_ms = currentTicks;
-    return true;
+void DynamicObject::updateAnimation(const Uint32 &dt) {
+  // A new state plays its animation from the start of this update
+  if (m_previousState != getState()) {
+    m_animations[unsigned(getState())].restart(getClock());
   }
-  return false;
+  advanceClock(dt);
+  m_previousState = getState();
 }
 
-void Timer::waitUntilNextTrigger() {
-  Uint32 currentTicks = SDL_GetTicks();
-  Uint32 remainingTicks =
-      std::min(m_interval_ms - (currentTicks - m_lastTick_ms), m_interval_ms);
-  SDL_Delay(remainingTicks);
-  m_lastTick_ms = SDL_GetTicks();
+void DynamicObject::render(RenderSnapshot &snapshot) {
+  m_animations[unsigned(getState())].render(
+      snapshot, getPreviousDestination(), getDestination(), getClock());
 }
 
-Uint32 Timer::getTimeSinceLastCall() {
-  Uint32 currTick = SDL_GetTicks();
-  Uint32 dt = currTick - m_lastCall_ms;
-  m_lastCall_ms = currTick;
-  return dt;
+void DynamicObject::addAnimation(const ObjState state,
+                                 const Animation &animation) {
+  m_animations[unsigned(state)] = animation;
 }
-// TIMER END
+// DYNAMIC OBJECT END
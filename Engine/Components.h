@@ -1,42 +1,60 @@
 #pragma once
 
 #include "Components_forward.h"
+#include "FixedPoint.h"
+#include "Input.h"
+#include "RenderSnapshot.h"
+#include "Span.h"
+#include "StateHash.h"
+#include "TextureManager.h"
 #include <SDL2/SDL.h>
+#include <array>
+#include <deque>
 #include <set>
-#include <unordered_map>
 #include <vector>
 
+// Converts normalized coordinates to screen pixels
+const SDL_Rect toAbsoluteRect(const Rectf &rect);
+
+// Source is relative to the image, queryTexture takes the whole image
 class Frame {
 public:
   Frame() = default;
-  Frame(SDL_Texture *texture, const SDL_Rect &source,
+  Frame(const TextureHandle &texture, const SDL_Rect &source,
         const bool queryTexture = false);
 
 public:
-  void render(SDL_Renderer *renderer, const SDL_Rect &destination);
+  void render(RenderSnapshot &snapshot, const Rectf &previous,
+              const Rectf &current) const;
 
   // Setters
-  void setTexture(SDL_Texture *texture, const bool queryTexture = false);
+  void setTexture(const TextureHandle &texture,
+                  const bool queryTexture = false);
   void setSource(const SDL_Rect &source, const bool queryTexture = false);
 
   // Getters
-  SDL_Texture *getTexture() const { return m_texture; }
+  const TextureHandle &getTexture() const { return m_texture; }
   const SDL_Rect &getSource() const { return m_src; }
 
 private:
-  SDL_Texture *m_texture = nullptr;
+  void updateTextureSource(const bool queryTexture);
+
+private:
+  TextureHandle m_texture;
   SDL_Rect m_src;
+  SDL_Rect m_textureSrc; // source within the texture holding the image
 };
 
 class AnimationFrame {
 public:
   AnimationFrame() = default;
   AnimationFrame(const Frame &frame, const Uint32 ticks);
-  AnimationFrame(SDL_Texture *texture, const SDL_Rect &source,
+  AnimationFrame(const TextureHandle &texture, const SDL_Rect &source,
                  const Uint32 &ticks, const bool queryTexture = false);
 
 public:
-  void render(SDL_Renderer *renderer, const SDL_Rect &destination);
+  void render(RenderSnapshot &snapshot, const Rectf &previous,
+              const Rectf &current) const;
 
   // Setters
   void setFrame(const Frame &frame) { m_frame = frame; }
@@ -51,23 +69,81 @@ private:
   Uint32 m_ticks;
 };
 
+// Immutable sequence of frames, shared by every animation playing it
+class AnimationClip {
+public:
+  AnimationClip() = default;
+  AnimationClip(const std::vector<AnimationFrame> &frames);
+
+public:
+  void render(RenderSnapshot &snapshot, const Rectf &previous,
+              const Rectf &current, const unsigned int frame) const;
+  void renderAt(RenderSnapshot &snapshot, const Rectf &previous,
+                const Rectf &current, const Uint32 &elapsed) const;
+  // Frame shown the given time after the clip started, looping
+  unsigned int getFrameAt(const Uint32 &elapsed) const;
+
+  // Getters
+  const AnimationFrame &getFrame(const unsigned int frame) const {
+    return m_frames[frame];
+  }
+  unsigned int getFrameCount() const { return m_frames.size(); }
+  Uint32 getTotalTicks() const { return m_totalTicks; }
+
+private:
+  std::vector<AnimationFrame> m_frames;
+  std::vector<Uint32> m_frameEnds; // time at the end of each frame
+  Uint32 m_totalTicks = 0;
+};
+
+using AnimationClipId = unsigned int;
+
+// Owns every clip of the game. Clips are never moved once added, so
+// animations can keep referring to them for the lifetime of the library.
+class AnimationLibrary {
+public:
+  AnimationLibrary() = default;
+  AnimationLibrary(const AnimationLibrary &) = delete; // no copy
+  AnimationLibrary &
+  operator=(const AnimationLibrary &) = delete; // no copy-assignment
+
+public:
+  AnimationClipId addClip(const std::vector<AnimationFrame> &frames);
+
+  // Getters
+  const AnimationClip &getClip(const AnimationClipId id) const {
+    return m_clips[id];
+  }
+  std::size_t size() const { return m_clips.size(); }
+
+private:
+  std::deque<AnimationClip> m_clips;
+};
+
+// Playback of a shared clip from a start time, in ms on the clock of its
+// owner. Nothing advances per tick: the frame is looked up from the time
+// when rendering, so animations never rendered cost nothing.
 class Animation {
 public:
   Animation() = default;
-  Animation(const std::vector<AnimationFrame> &animation);
+  Animation(const AnimationClip &clip, const Uint32 &start = 0);
 
 public:
-  void addFrame(const AnimationFrame &frame);
-  void addFrames(const std::vector<AnimationFrame> &frames);
-  void render(SDL_Renderer *renderer, const SDL_Rect &destination);
-  void update(const Uint32 &dt);
-  void reset();
+  void render(RenderSnapshot &snapshot, const Rectf &previous,
+              const Rectf &current, const Uint32 &time) const;
+  void restart(const Uint32 &time) { m_start = time; }
+
+  // Setters
+  void setClip(const AnimationClip &clip, const Uint32 &start = 0);
+
+  // Getters
+  const AnimationClip *getClip() const { return m_clip; }
+  Uint32 getStart() const { return m_start; }
+  unsigned int getFrame(const Uint32 &time) const;
 
 private:
-  std::vector<AnimationFrame> m_frames;
-  Uint32 m_currTicks = 0;
-  unsigned int m_currFrame = 0;
-  unsigned int m_nFrames = 0;
+  const AnimationClip *m_clip = nullptr;
+  Uint32 m_start = 0;
 };
 
 class Object {
@@ -78,21 +154,40 @@ public:
 
 public:
   virtual void update(const Uint32 &dt);
-  virtual void render(SDL_Renderer *renderer);
+  virtual void render(RenderSnapshot &snapshot);
   void scale(const float factor);
-  bool isColiding(const Object &obj);
-  void updatePosX(const float dx) { m_dst.x += dx; }
-  void updatePosY(const float dy) { m_dst.y += dy; }
+  bool isColiding(const Object &obj) const;
+  bool isColiding(const Rectf &rect) const;
+  void updatePosX(const float dx) {
+    m_dst.x += dx;
+    syncDestination();
+  }
+  void updatePosY(const float dy) {
+    m_dst.y += dy;
+    syncDestination();
+  }
+  void storePreviousDestination() { m_prevDst = m_dst; }
 
   // Setters
   void setState(const ObjState state) { m_state = state; }
   void setPos(const float x, const float y) {
     m_dst.x = x;
     m_dst.y = y;
+    syncDestination();
+  }
+  void setPosX(const float x) {
+    m_dst.x = x;
+    syncDestination();
+  }
+  void setPosY(const float y) {
+    m_dst.y = y;
+    syncDestination();
+  }
+  void setDestination(const Rectf &dst) {
+    m_dst = dst;
+    syncDestination();
+    m_prevDst = m_dst;
   }
-  void setPosX(const float x) { m_dst.x = x; }
-  void setPosY(const float y) { m_dst.y = y; }
-  void setDestination(const Rectf &dst) { m_dst = dst; }
   void setAnimation(const Animation &animation) { m_animation = animation; }
 
   // Getters
@@ -104,121 +199,119 @@ public:
   float getOppositeX() const { return m_dst.x + m_dst.w; }
   float getOppositeY() const { return m_dst.y + m_dst.h; }
   const Rectf &getDestination() const { return m_dst; }
+  const Rectf &getPreviousDestination() const { return m_prevDst; }
   const SDL_Rect getAbsoluteDestination() const;
+  Uint32 getClock() const { return m_clock; }
+
+protected:
+  void advanceClock(const Uint32 &dt) { m_clock += dt; }
+  // Rounds the destination to the fixed-point one, which is the one the
+  // physics work on. Does nothing without FIXED_POINT_PHYSICS.
+  void syncDestination();
+#ifdef FIXED_POINT_PHYSICS
+  void setFixedDestination(const FixedRect &dst);
+  const FixedRect &getFixedDestination() const { return m_fixedDst; }
+#endif
 
 private:
   Animation m_animation;
+  Uint32 m_clock = 0; // ms updated so far, animations play on it
+#ifdef FIXED_POINT_PHYSICS
+  FixedRect m_fixedDst = {}; // in pixels, up to 32767
+#endif
   Rectf m_dst;
+  Rectf m_prevDst; // destination before the last update, for interpolation
   ObjState m_state = ObjState::Idle;
 };
 
+// Animation of every state, states without one show nothing
+using StateAnimations = std::array<Animation, ObjStateCount>;
+
 class DynamicObject : public Object {
 public:
   DynamicObject() = default;
-  DynamicObject(const std::unordered_map<ObjState, Animation> &animations,
-                const Rectf &destination, const float vx = 0.0f,
-                const float vy = 0.0f, const bool gravitySensitive = true,
-                const float scale = 1.0f,
+  DynamicObject(const StateAnimations &animations, const Rectf &destination,
+                const float vx = 0.0f, const float vy = 0.0f,
+                const bool gravitySensitive = true, const float scale = 1.0f,
                 const ObjState state = ObjState::Idle);
 
 public:
   // Others
   void update(const Uint32 &dt) override;
-  void render(SDL_Renderer *renderer) override;
+  void render(RenderSnapshot &snapshot) override;
   void addAnimation(const ObjState state, const Animation &animation);
 
   // Setters
   void setVelocity(const float vx, const float vy) {
     m_vx = vx;
     m_vy = vy;
+    syncVelocity();
+  }
+  void setVelocityX(const float vx) {
+    m_vx = vx;
+    syncVelocity();
+  }
+  void setVelocityY(const float vy) {
+    m_vy = vy;
+    syncVelocity();
   }
-  void setVelocityX(const float vx) { m_vx = vx; }
-  void setVelocityY(const float vy) { m_vy = vy; }
   void setGravitySensitive(const bool gravStv) { m_gravitySensitive = gravStv; }
 
   // Getters
   float getVelocityX() const { return m_vx; }
   float getVelocityY() const { return m_vy; }
+  bool isOnFloor() const;
+
+protected:
+  void integrate(const float dt);
+  void updateAnimation(const Uint32 &dt);
+#ifdef FIXED_POINT_PHYSICS
+  FixedVelocity getFixedVelocity() const { return {m_fixedVx, m_fixedVy}; }
+#endif
+
+private:
+  // Same as syncDestination, for the velocity
+  void syncVelocity();
 
 private:
   float m_vx = 0.0f;
   float m_vy = 0.0f;
+#ifdef FIXED_POINT_PHYSICS
+  Fixed m_fixedVx = 0; // pixels per ms
+  Fixed m_fixedVy = 0;
+#endif
   bool m_gravitySensitive = true;
-  std::unordered_map<ObjState, Animation> m_animations;
+  StateAnimations m_animations;
   ObjState m_previousState = ObjState::Idle;
 };
 
 class Player : public DynamicObject {
 public:
   Player() = default;
-  Player(const std::unordered_map<ObjState, Animation> &animations,
-         const Rectf &destination, const int health, const Uint32 &fireRate,
-         const float vx = 0.0f, const float vy = 0.0f,
-         const bool gravitySensitive = true, const float scale = 1.0f,
-         const ObjState state = ObjState::Idle);
+  Player(const StateAnimations &animations, const Rectf &destination,
+         const int health, const Uint32 &fireRate, const float vx = 0.0f,
+         const float vy = 0.0f, const bool gravitySensitive = true,
+         const float scale = 1.0f, const ObjState state = ObjState::Idle);
 
 public:
-  void update(const Uint32 &dt, const std::vector<KbdEvents> &events);
+  // Events are applied at their offset within the update
+  void update(const Uint32 &dt, const Span<const TickEvent> &events);
   bool shouldSpawnBullet();
+  void hashState(StateHash &hash) const;
 
   // Setters
   void setHealth(const int health) { m_health = health; }
   void setFireRate(const int fireRate) { m_fireRate = 1000 / fireRate; }
 
   // Queries
-  bool isFiring();
+  bool isFiring() const;
 
 private:
-  void handleIdleState(const KbdEvents event);
-  void handleMovingState(const KbdEvents event);
-  void handleJumpingState(const KbdEvents event);
-  void handleFiringState(const KbdEvents event);
-  void handleFiringAndMovingState(const KbdEvents event);
-  void handleFiringAndJumpingState(const KbdEvents event);
+  void applyEvent(const KbdEvents event);
+  void land();
 
 private:
   int m_health = 100;
   Uint32 m_bulletTimer = 0;
   Uint32 m_fireRate = 100; // fire every X ticks
 };
-
-class Projectile : public DynamicObject {
-public:
-  Projectile() = default;
-  Projectile(const std::unordered_map<ObjState, Animation> &animations,
-             const Rectf &destination, const int damage, const Uint32 &lifeSpan,
-             const float vx = 0.0f, const float vy = 0.0f,
-             const bool gravitySensitive = true, const float scale = 1.0f,
-             const ObjState state = ObjState::Moving);
-
-public:
-  void update(const Uint32 &dt);
-  bool endedLifespan() const { return m_endedLifespan; }
-  void hitted();
-
-  // Setters
-  void setLifeSpan(const Uint32 &lifeSpan) { m_lifeSpan = lifeSpan; }
-  void setDamage(const int damage) { m_damage = damage; }
-
-private:
-  Uint32 m_lifeSpan = 0;
-  int m_damage = 0;
-  bool m_endedLifespan = false;
-};
-
-class Timer {
-public:
-  Timer();
-  Timer(const Uint32 interval);
-
-public:
-  void setInterval(const Uint32 interval) { m_interval_ms = interval; }
-  bool triggered();
-  void waitUntilNextTrigger();
-  Uint32 getTimeSinceLastCall();
-
-private:
-  Uint32 m_interval_ms = 100;
-  Uint32 m_lastTick_ms = 0;
-  Uint32 m_lastCall_ms = 0;
-};
@@ -14,6 +14,9 @@ enum class KbdEvents {
   Space_KeyDown,
   Space_KeyUp,
 };
+constexpr unsigned int KbdEventCount = 12;
+static_assert(unsigned(KbdEvents::Space_KeyUp) + 1 == KbdEventCount,
+              "KbdEventCount must follow the events");
 
 enum class ObjState {
   Idle,
@@ -23,6 +26,9 @@ enum class ObjState {
   FiringAndMoving,
   FiringAndJumping
 };
+constexpr unsigned int ObjStateCount = 6;
+static_assert(unsigned(ObjState::FiringAndJumping) + 1 == ObjStateCount,
+              "ObjStateCount must follow the states");
 
 struct Rectf {
   float x, y, w, h;
@@ -32,6 +38,10 @@ class Frame;
 
 class AnimationFrame;
 
+class AnimationClip;
+
+class AnimationLibrary;
+
 class Animation;
 
 class Object;
@@ -39,7 +49,3 @@ class Object;
 class DynamicObject;
 
 class Player;
-
-class Projectile;
-
-class Time;
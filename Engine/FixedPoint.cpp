@@ -0,0 +1,39 @@
+#include "FixedPoint.h"
+#include "../Game/Definitions.h"
+
+#ifdef FIXED_POINT_PHYSICS
+Fixed toFixedX(const float x) { return toFixed(x * Global::SDL::ScreenWidth); }
+
+Fixed toFixedY(const float y) {
+  return toFixed(y * Global::SDL::ScreenHeight);
+}
+
+// A single product, so even -ffast-math can't round it another way
+float toNormalizedX(const Fixed x) {
+  return float(x) * (1.0f / (FixedOne * Global::SDL::ScreenWidth));
+}
+
+float toNormalizedY(const Fixed y) {
+  return float(y) * (1.0f / (FixedOne * Global::SDL::ScreenHeight));
+}
+
+FixedRect toFixedRect(const Rectf &rect) {
+  return {toFixedX(rect.x), toFixedY(rect.y), toFixedX(rect.w),
+          toFixedY(rect.h)};
+}
+
+Rectf toNormalizedRect(const FixedRect &rect) {
+  return {toNormalizedX(rect.x), toNormalizedY(rect.y), toNormalizedX(rect.w),
+          toNormalizedY(rect.h)};
+}
+
+Fixed getFixedFloor() {
+  static const Fixed floor = toFixedY(Global::Game::Floor);
+  return floor;
+}
+
+Fixed getFixedGravity() {
+  static const Fixed gravity = toFixedY(Global::Game::Gravity);
+  return gravity;
+}
+#endif
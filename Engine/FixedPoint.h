@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Components_forward.h"
+#include <SDL2/SDL.h>
+#include <cmath>
+
+// 16.16 fixed-point numbers for the physics built with FIXED_POINT_PHYSICS.
+// Only integer math touches them, so the results are bit-exact whatever the
+// compiler, flags or CPU. Shifts of negative values are arithmetic on every
+// compiler the game is built with.
+using Fixed = Sint32;
+constexpr int FixedShift = 16;
+constexpr Fixed FixedOne = Fixed(1) << FixedShift;
+
+#ifdef FIXED_POINT_PHYSICS
+constexpr bool UseFixedPointPhysics = true;
+#else
+constexpr bool UseFixedPointPhysics = false;
+#endif
+
+struct FixedRect {
+  Fixed x, y, w, h;
+};
+
+struct FixedVelocity {
+  Fixed vx, vy; // pixels per ms
+};
+
+// Nearest fixed-point value, exact for the same float on every machine
+inline Fixed toFixed(const float value) {
+  return Fixed(std::lround(value * FixedOne));
+}
+
+inline float toFloat(const Fixed value) { return float(value) / FixedOne; }
+
+// Whole part, rounded towards minus infinity
+inline int toInt(const Fixed value) { return value >> FixedShift; }
+
+// Product rounded towards minus infinity, without overflowing in between
+inline Fixed fixedMul(const Fixed a, const Fixed b) {
+  return Fixed((Sint64(a) * b) >> FixedShift);
+}
+
+#ifdef FIXED_POINT_PHYSICS
+// Physics positions are kept in pixels, so they map to the screen with a
+// shift. These convert them from and to normalized screen coordinates.
+Fixed toFixedX(const float x);
+Fixed toFixedY(const float y);
+float toNormalizedX(const Fixed x);
+float toNormalizedY(const Fixed y);
+FixedRect toFixedRect(const Rectf &rect);
+Rectf toNormalizedRect(const FixedRect &rect);
+
+// Global::Game::Floor and Gravity in pixels
+Fixed getFixedFloor();
+Fixed getFixedGravity();
+#endif
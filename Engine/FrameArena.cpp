@@ -0,0 +1,52 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+
+// FRAME ARENA START
+FrameArena::FrameArena(const std::size_t capacity)
+    : m_memory(capacity > 0 ? new unsigned char[capacity] : nullptr),
+      m_capacity(capacity) {}
+
+void FrameArena::reset() {
+  const std::size_t used = getUsed();
+  m_peak = std::max(m_peak, used);
+  if (m_overflowBytes > 0) {
+    // Room for the whole tick next time, with some slack
+    m_capacity = m_peak + m_peak / 2;
+    m_memory.reset(new unsigned char[m_capacity]);
+    m_overflow.release();
+    m_overflowBytes = 0;
+  }
+  m_offset.store(0, std::memory_order_relaxed);
+}
+
+std::size_t FrameArena::getUsed() const {
+  return m_offset.load(std::memory_order_relaxed) + m_overflowBytes;
+}
+
+void *FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  // Claims the aligned block with a compare-exchange, concurrent jobs each
+  // get their own bytes
+  const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_memory.get());
+  std::size_t offset = m_offset.load(std::memory_order_relaxed);
+  std::size_t aligned;
+  do {
+    aligned = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+    if (aligned + bytes > m_capacity) {
+      break;
+    }
+  } while (!m_offset.compare_exchange_weak(offset, aligned + bytes,
+                                           std::memory_order_relaxed));
+  if (aligned + bytes <= m_capacity) {
+    return m_memory.get() + aligned;
+  }
+
+  std::lock_guard<std::mutex> lock(m_overflowMutex);
+  m_overflowBytes += bytes;
+  return m_overflow.allocate(bytes, alignment);
+}
+
+void FrameArena::do_deallocate(void *, std::size_t, std::size_t) {
+  // Released by reset()
+}
+// FRAME ARENA END
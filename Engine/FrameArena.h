@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+// Bump allocator for data that lives for one tick, usable by std::pmr
+// containers. Allocating only moves an atomic offset, so jobs can allocate
+// from it concurrently, and deallocating does nothing: reset() releases
+// everything at once. Allocations that do not fit go to the heap, and the
+// next reset grows the arena to the peak seen, so ticks no larger than
+// earlier ones only touch the arena.
+class FrameArena : public std::pmr::memory_resource {
+public:
+  explicit FrameArena(const std::size_t capacity = 0);
+  FrameArena(const FrameArena &) = delete;            // no copy
+  FrameArena &operator=(const FrameArena &) = delete; // no copy-assignment
+
+public:
+  // Nothing allocated before may be used after, and nothing may allocate
+  // meanwhile
+  void reset();
+
+  // Getters
+  std::size_t getCapacity() const { return m_capacity; }
+  std::size_t getUsed() const; // this tick, including overflow
+  std::size_t getPeak() const { return m_peak; }
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *memory, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+private:
+  std::unique_ptr<unsigned char[]> m_memory;
+  std::size_t m_capacity = 0;
+  std::atomic<std::size_t> m_offset{0};
+
+  // Heap blocks of the allocations that did not fit
+  std::mutex m_overflowMutex;
+  std::pmr::monotonic_buffer_resource m_overflow;
+  std::size_t m_overflowBytes = 0;
+  std::size_t m_peak = 0; // highest use of a tick so far
+};
@@ -0,0 +1,53 @@
+#include "Input.h"
+
+// INPUT START
+static_assert(int(KbdEvents::Up_KeyDown) == 0 &&
+                  int(KbdEvents::Space_KeyUp) == 11,
+              "key events must pair up as down then up");
+static_assert(int(Key::Up) == 0 && int(Key::Space) * 2 ==
+                                       int(KbdEvents::Space_KeyDown),
+              "keys must follow the order of their events");
+
+Key toKey(const KbdEvents event) {
+  switch (event) {
+  case KbdEvents::Up_KeyDown:
+  case KbdEvents::Up_KeyUp:
+    return Key::Up;
+  case KbdEvents::Down_KeyDown:
+  case KbdEvents::Down_KeyUp:
+    return Key::Down;
+  case KbdEvents::Left_KeyDown:
+  case KbdEvents::Left_KeyUp:
+    return Key::Left;
+  case KbdEvents::Right_KeyDown:
+  case KbdEvents::Right_KeyUp:
+    return Key::Right;
+  case KbdEvents::LCtrl_KeyDown:
+  case KbdEvents::LCtrl_KeyUp:
+    return Key::LCtrl;
+  case KbdEvents::Space_KeyDown:
+  case KbdEvents::Space_KeyUp:
+    return Key::Space;
+  }
+  return Key::Count;
+}
+
+bool isKeyDown(const KbdEvents event) {
+  // Every key lists its down event right before its up event
+  return (int(event) & 1) == 0;
+}
+
+KbdEvents toKbdEvent(const Key key, const bool down) {
+  return KbdEvents(int(key) * 2 + (down ? 0 : 1));
+}
+// INPUT END
+
+// KEYBOARD STATE START
+void KeyboardState::apply(const KbdEvents event) {
+  const Key key = toKey(event);
+  if (key == Key::Count) {
+    return;
+  }
+  m_down[index(key)] = isKeyDown(event);
+}
+// KEYBOARD STATE END
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Components_forward.h"
+#include <SDL2/SDL.h>
+#include <bitset>
+
+enum class Key { Up, Down, Left, Right, LCtrl, Space, Count };
+
+// A keyboard transition, stamped with the performance counter when it was
+// captured
+struct InputEvent {
+  KbdEvents event;
+  Uint64 time;
+};
+
+// An event placed within a model update, in ms since the update started
+struct TickEvent {
+  KbdEvents event;
+  float offset;
+};
+
+Key toKey(const KbdEvents event);
+bool isKeyDown(const KbdEvents event);
+KbdEvents toKbdEvent(const Key key, const bool down);
+
+// Which keys are held
+class KeyboardState {
+public:
+  KeyboardState() = default;
+
+public:
+  void apply(const KbdEvents event);
+
+  // Getters
+  bool isDown(const Key key) const { return m_down[index(key)]; }
+
+private:
+  static std::size_t index(const Key key) { return std::size_t(key); }
+
+private:
+  std::bitset<std::size_t(Key::Count)> m_down;
+};
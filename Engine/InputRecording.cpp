@@ -0,0 +1,101 @@
+#include "InputRecording.h"
+#include "FixedPoint.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// INPUT RECORDER START
+void InputRecorder::start(const std::string &filePath, const Uint32 modelRate) {
+  m_filePath = filePath;
+  m_modelRate = modelRate;
+  m_events.clear();
+}
+
+void InputRecorder::record(const Uint32 tick,
+                           const Span<const TickEvent> &events) {
+  for (const auto &input : events) {
+    m_events.push_back({tick, input.offset, Uint32(input.event)});
+  }
+}
+
+bool InputRecorder::finish(const Uint32 nTicks, const Uint64 checksum) {
+  if (!isRecording()) {
+    return false;
+  }
+  std::ofstream file(m_filePath, std::ios::binary);
+  m_filePath.clear();
+  if (!file) {
+    std::cout << "Couldn't create input recording" << std::endl;
+    return false;
+  }
+  RecordingHeader header = {};
+  std::memcpy(header.magic, RecordingMagic, sizeof(RecordingMagic));
+  header.version = RecordingVersion;
+  header.modelRate = m_modelRate;
+  header.nTicks = nTicks;
+  header.nEvents = m_events.size();
+  header.fixedPoint = UseFixedPointPhysics;
+  header.checksum = checksum;
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(m_events.data()),
+             m_events.size() * sizeof(RecordedEvent));
+  return bool(file);
+}
+// INPUT RECORDER END
+
+// INPUT REPLAY START
+bool InputReplay::load(const std::string &filePath) {
+  m_header = {};
+  m_ticks.clear();
+  m_events.clear();
+  m_next = 0;
+
+  std::ifstream file(filePath, std::ios::binary);
+  if (!file) {
+    std::cout << "Couldn't open input recording " << filePath << std::endl;
+    return false;
+  }
+  RecordingHeader header;
+  std::vector<RecordedEvent> events;
+  bool valid =
+      bool(file.read(reinterpret_cast<char *>(&header), sizeof(header))) &&
+      std::memcmp(header.magic, RecordingMagic, sizeof(RecordingMagic)) == 0 &&
+      header.version == RecordingVersion;
+  if (valid) {
+    events.resize(header.nEvents);
+    valid = bool(file.read(reinterpret_cast<char *>(events.data()),
+                           events.size() * sizeof(RecordedEvent)));
+  }
+  // Events must be in order, within the recording and be key events
+  Uint32 lastTick = 0;
+  for (std::size_t i = 0; valid && i < events.size(); ++i) {
+    valid = events[i].tick >= lastTick && events[i].tick < header.nTicks &&
+            toKey(KbdEvents(events[i].event)) != Key::Count;
+    lastTick = events[i].tick;
+  }
+  if (!valid) {
+    std::cout << "Invalid input recording " << filePath << std::endl;
+    return false;
+  }
+
+  m_header = header;
+  m_ticks.reserve(events.size());
+  m_events.reserve(events.size());
+  for (const auto &recorded : events) {
+    m_ticks.push_back(recorded.tick);
+    m_events.push_back({KbdEvents(recorded.event), recorded.offset});
+  }
+  return true;
+}
+
+Span<const TickEvent> InputReplay::getEvents(const Uint32 tick) {
+  while (m_next < m_ticks.size() && m_ticks[m_next] < tick) {
+    ++m_next; // updates skipped by the caller
+  }
+  const std::size_t first = m_next;
+  while (m_next < m_ticks.size() && m_ticks[m_next] == tick) {
+    ++m_next;
+  }
+  return Span<const TickEvent>(m_events.data() + first, m_next - first);
+}
+// INPUT REPLAY END
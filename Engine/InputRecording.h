@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Input.h"
+#include "Span.h"
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+// On-disk layout of an input recording, in native byte order:
+//   RecordingHeader
+//   RecordedEvent[nEvents], in the order they were applied
+const char RecordingMagic[4] = {'S', 'T', 'G', 'R'};
+const Uint32 RecordingVersion = 1;
+
+struct RecordingHeader {
+  char magic[4];
+  Uint32 version;
+  Uint32 modelRate; // updates per second the recording was made at
+  Uint32 nTicks;
+  Uint32 nEvents;
+  Uint32 fixedPoint; // 1 if made with FIXED_POINT_PHYSICS
+  Uint64 checksum; // of the model state after the last update
+};
+
+struct RecordedEvent {
+  Uint32 tick;  // model update the event was applied on
+  float offset; // ms since the update started
+  Uint32 event; // KbdEvents
+};
+
+// Collects the events of every model update in memory, and writes them out
+// once the session ends
+class InputRecorder {
+public:
+  InputRecorder() = default;
+
+public:
+  void start(const std::string &filePath, const Uint32 modelRate);
+  void record(const Uint32 tick, const Span<const TickEvent> &events);
+  bool finish(const Uint32 nTicks, const Uint64 checksum);
+
+  // Getters
+  bool isRecording() const { return !m_filePath.empty(); }
+
+private:
+  std::string m_filePath;
+  Uint32 m_modelRate = 0;
+  std::vector<RecordedEvent> m_events;
+};
+
+// Hands back the events of a recording one model update at a time
+class InputReplay {
+public:
+  InputReplay() = default;
+
+public:
+  bool load(const std::string &filePath);
+  // Events of the given update. Updates must be asked for in order.
+  Span<const TickEvent> getEvents(const Uint32 tick);
+
+  // Getters
+  Uint32 getModelRate() const { return m_header.modelRate; }
+  Uint32 getTickCount() const { return m_header.nTicks; }
+  Uint64 getChecksum() const { return m_header.checksum; }
+  bool isFixedPoint() const { return m_header.fixedPoint != 0; }
+
+private:
+  RecordingHeader m_header{};
+  std::vector<Uint32> m_ticks;
+  std::vector<TickEvent> m_events;
+  std::size_t m_next = 0;
+};
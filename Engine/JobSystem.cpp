@@ -0,0 +1,149 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+// JOB SYSTEM START
+JobSystem::JobSystem(const unsigned int nWorkers) {
+  for (unsigned int i = 0; i <= nWorkers; ++i) {
+    m_queues.push_back(std::make_unique<TaskQueue>());
+  }
+  for (unsigned int i = 0; i < nWorkers; ++i) {
+    m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_quit = true;
+  }
+  m_wake.notify_all();
+  for (auto &thread : m_threads) {
+    thread.join();
+  }
+}
+
+void JobSystem::run(const std::size_t count, const std::size_t chunkSize,
+                    void *context, Invoker invoke) {
+  if (count == 0) {
+    return;
+  }
+  const std::size_t chunk = chunkSize == 0 ? count : chunkSize;
+  if (m_threads.empty()) {
+    for (std::size_t begin = 0; begin < count; begin += chunk) {
+      invoke(context, begin, std::min(begin + chunk, count));
+    }
+    return;
+  }
+
+  // Deal the chunks over every queue, the workers balance the rest by
+  // stealing
+  Batch batch{context, invoke, {chunkCount(count, chunk)}};
+  m_queued += batch.remaining;
+  std::size_t queue = 0;
+  for (std::size_t begin = 0; begin < count; begin += chunk) {
+    TaskQueue &tasks = *m_queues[queue];
+    {
+      std::lock_guard<std::mutex> lock(tasks.mutex);
+      tasks.pushBack({&batch, begin, std::min(begin + chunk, count)});
+    }
+    queue = (queue + 1) % m_queues.size();
+  }
+  {
+    // Makes sure no worker is between its wake check and its wait
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+  }
+  m_wake.notify_all();
+
+  // Help until every chunk of the batch is done
+  const unsigned int caller = m_queues.size() - 1;
+  Task task;
+  while (batch.remaining.load(std::memory_order_acquire) > 0) {
+    if (findTask(caller, task)) {
+      execute(task);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+bool JobSystem::popTask(const unsigned int queue, Task &task) {
+  TaskQueue &tasks = *m_queues[queue];
+  std::lock_guard<std::mutex> lock(tasks.mutex);
+  if (!tasks.popBack(task)) {
+    return false;
+  }
+  --m_queued;
+  return true;
+}
+
+bool JobSystem::stealTask(const unsigned int thief, Task &task) {
+  for (unsigned int offset = 1; offset < m_queues.size(); ++offset) {
+    TaskQueue &tasks = *m_queues[(thief + offset) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(tasks.mutex);
+    if (tasks.popFront(task)) {
+      --m_queued;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool JobSystem::findTask(const unsigned int queue, Task &task) {
+  return popTask(queue, task) || stealTask(queue, task);
+}
+
+void JobSystem::execute(const Task &task) {
+  task.batch->invoke(task.batch->context, task.begin, task.end);
+  task.batch->remaining.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(const unsigned int queue) {
+  Task task;
+  while (true) {
+    if (findTask(queue, task)) {
+      execute(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wake.wait(lock, [this]() { return m_quit || m_queued > 0; });
+    if (m_quit) {
+      return;
+    }
+  }
+}
+// JOB SYSTEM END
+
+// TASK QUEUE START
+void JobSystem::TaskQueue::pushBack(const Task &task) {
+  if (size == ring.size()) {
+    // Unwrap into a larger ring
+    std::vector<Task> grown(std::max(ring.size() * 2, std::size_t(16)));
+    for (std::size_t i = 0; i < size; ++i) {
+      grown[i] = ring[(front + i) % ring.size()];
+    }
+    ring.swap(grown);
+    front = 0;
+  }
+  ring[(front + size) % ring.size()] = task;
+  ++size;
+}
+
+bool JobSystem::TaskQueue::popBack(Task &task) {
+  if (size == 0) {
+    return false;
+  }
+  --size;
+  task = ring[(front + size) % ring.size()];
+  return true;
+}
+
+bool JobSystem::TaskQueue::popFront(Task &task) {
+  if (size == 0) {
+    return false;
+  }
+  task = ring[front];
+  front = (front + 1) % ring.size();
+  --size;
+  return true;
+}
+// TASK QUEUE END
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing scheduler for data parallel loops. Each worker owns a deque
+// of chunks, pops its own work from the back and steals from the front of
+// the other deques when it runs dry. The calling thread takes part in the
+// work, so a job system without workers simply runs everything inline.
+class JobSystem {
+public:
+  JobSystem(const unsigned int nWorkers);
+  ~JobSystem();
+  JobSystem(const JobSystem &) = delete;            // no copy
+  JobSystem &operator=(const JobSystem &) = delete; // no copy-assignment
+  JobSystem(JobSystem &&) = delete;                 // no move
+  JobSystem &operator=(JobSystem &&) = delete;      // no move-assignment
+
+public:
+  // Calls job(begin, end) for every chunk of [0, count) and returns once all
+  // chunks are done. Chunk boundaries only depend on count and chunkSize, so
+  // results written per chunk can be merged in a stable order.
+  template <typename Job>
+  void parallelFor(const std::size_t count, const std::size_t chunkSize,
+                   Job &&job) {
+    using JobType = typename std::remove_reference<Job>::type;
+    run(count, chunkSize, &job, [](void *context, std::size_t begin,
+                                   std::size_t end) {
+      (*static_cast<JobType *>(context))(begin, end);
+    });
+  }
+
+  // Getters
+  unsigned int getWorkerCount() const { return m_threads.size(); }
+  static std::size_t chunkCount(const std::size_t count,
+                                const std::size_t chunkSize) {
+    return (count + chunkSize - 1) / chunkSize;
+  }
+
+private:
+  using Invoker = void (*)(void *, std::size_t, std::size_t);
+
+  struct Batch {
+    void *context;
+    Invoker invoke;
+    std::atomic<std::size_t> remaining;
+  };
+
+  struct Task {
+    Batch *batch;
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  // Ring of tasks, grown when full and never shrunk, so that batches no
+  // larger than earlier ones do not allocate
+  struct TaskQueue {
+    std::mutex mutex;
+    std::vector<Task> ring;
+    std::size_t front = 0;
+    std::size_t size = 0;
+
+    void pushBack(const Task &task);
+    bool popBack(Task &task);
+    bool popFront(Task &task);
+  };
+
+  void run(const std::size_t count, const std::size_t chunkSize,
+           void *context, Invoker invoke);
+  bool popTask(const unsigned int queue, Task &task);
+  bool stealTask(const unsigned int thief, Task &task);
+  bool findTask(const unsigned int queue, Task &task);
+  void execute(const Task &task);
+  void workerLoop(const unsigned int queue);
+
+private:
+  // One queue per worker plus a last one for the calling thread
+  std::vector<std::unique_ptr<TaskQueue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wake;
+  std::atomic<std::size_t> m_queued{0};
+  bool m_quit = false;
+};
+
+// Runs the loop on the job system when there is one, inline otherwise
+template <typename Job>
+void parallelFor(JobSystem *jobs, const std::size_t count,
+                 const std::size_t chunkSize, Job &&job) {
+  if (jobs) {
+    jobs->parallelFor(count, chunkSize, job);
+  } else if (count > 0) {
+    job(std::size_t(0), count);
+  }
+}
@@ -0,0 +1,79 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+
+// HISTOGRAM START
+void Histogram::record(const Uint64 us) {
+  m_buckets[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  if (us > m_max.load(std::memory_order_relaxed)) {
+    m_max.store(us, std::memory_order_relaxed);
+  }
+}
+
+void Histogram::reset() {
+  for (auto &bucket : m_buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  m_count.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+Uint64 Histogram::getPercentile(const double percent) const {
+  // Counted from the buckets, which the recording thread may be updating
+  Uint64 total = 0;
+  for (const auto &bucket : m_buckets) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  if (total == 0) {
+    return 0;
+  }
+  const Uint64 rank =
+      std::max(Uint64(std::ceil(percent / 100.0 * total)), Uint64(1));
+  Uint64 seen = 0;
+  for (std::size_t i = 0; i < BucketCount; ++i) {
+    seen += m_buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(bucketEnd(i), getMax());
+    }
+  }
+  return getMax();
+}
+
+std::size_t Histogram::bucketIndex(const Uint64 value) {
+  const Uint64 clamped =
+      std::min(value, (Uint64(1) << RangeBits) - 1);
+  if (clamped < (Uint64(1) << PrecisionBits)) {
+    return std::size_t(clamped);
+  }
+  // Buckets of each power of two split it in SubBuckets equal parts
+  unsigned int top = PrecisionBits;
+  while (clamped >> (top + 1)) {
+    ++top;
+  }
+  const unsigned int shift = top + 1 - PrecisionBits;
+  return shift * SubBuckets + std::size_t(clamped >> shift);
+}
+
+Uint64 Histogram::bucketEnd(const std::size_t index) {
+  if (index < (std::size_t(1) << PrecisionBits)) {
+    return index;
+  }
+  const std::size_t shift = index / SubBuckets - 1;
+  const Uint64 mantissa = index - shift * SubBuckets;
+  return ((mantissa + 1) << shift) - 1;
+}
+// HISTOGRAM END
+
+// GAUGE START
+void Gauge::set(const Uint64 value) {
+  m_value.store(value, std::memory_order_relaxed);
+  if (value > m_max.load(std::memory_order_relaxed)) {
+    m_max.store(value, std::memory_order_relaxed);
+  }
+}
+// GAUGE END
+
+Uint64 countsToUs(const Uint64 counts) {
+  return counts * 1000000 / SDL_GetPerformanceFrequency();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Log-linear histogram of durations in microseconds, HDR style: values are
+// exact below 2^PrecisionBits and rounded up by at most 1/32 above, up to about
+// 71 minutes. Recording never allocates. One thread records while any other
+// can read percentiles or reset it.
+class Histogram {
+public:
+  static const unsigned int PrecisionBits = 6;
+  static const unsigned int RangeBits = 32;
+
+  Histogram() = default;
+
+public:
+  void record(const Uint64 us);
+  void reset();
+  // Smallest recorded value that percent of the samples do not exceed,
+  // rounded up to the end of its bucket
+  Uint64 getPercentile(const double percent) const;
+
+  // Getters
+  Uint64 getCount() const { return m_count.load(std::memory_order_relaxed); }
+  Uint64 getMax() const { return m_max.load(std::memory_order_relaxed); }
+
+private:
+  static std::size_t bucketIndex(const Uint64 value);
+  static Uint64 bucketEnd(const std::size_t index);
+
+private:
+  static const std::size_t SubBuckets = std::size_t(1) << (PrecisionBits - 1);
+  static const std::size_t BucketCount =
+      (RangeBits - PrecisionBits + 2) * SubBuckets;
+
+  std::array<std::atomic<Uint32>, BucketCount> m_buckets{};
+  std::atomic<Uint64> m_count{0};
+  std::atomic<Uint64> m_max{0};
+};
+
+// Last value of a quantity sampled once per update or frame, and the
+// highest since the last reset
+class Gauge {
+public:
+  Gauge() = default;
+
+public:
+  void set(const Uint64 value);
+  void reset() { m_max.store(0, std::memory_order_relaxed); }
+
+  // Getters
+  Uint64 getValue() const { return m_value.load(std::memory_order_relaxed); }
+  Uint64 getMax() const { return m_max.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<Uint64> m_value{0};
+  std::atomic<Uint64> m_max{0};
+};
+
+// Performance counter interval in microseconds
+Uint64 countsToUs(const Uint64 counts);
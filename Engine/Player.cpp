@@ -1,43 +1,39 @@
-#include "../Game/Definitions.h"
 #include "Components.h"
+#include "PlayerStates.h"
+#include "Profiler.h"
+#include <algorithm>
 
 // PLAYER BEGIN
-Player::Player(const std::unordered_map<ObjState, Animation> &animations,
-               const Rectf &destination, const int health,
-               const Uint32 &fireRate, const float vx, const float vy,
-               const bool gravitySensitive, const float scale,
+Player::Player(const StateAnimations &animations, const Rectf &destination,
+               const int health, const Uint32 &fireRate, const float vx,
+               const float vy, const bool gravitySensitive, const float scale,
                const ObjState state)
     : DynamicObject(animations, destination, vx, vy, gravitySensitive, scale,
                     state),
       m_health(health), m_fireRate(1000 / fireRate) {}
 
-void Player::update(const Uint32 &dt, const std::vector<KbdEvents> &events) {
-  // Handle events
-  const auto previousState = getState();
-  for (const auto event : events) {
-    switch (getState()) {
-    case ObjState::Idle:
-      handleIdleState(event);
-      break;
-    case ObjState::Moving:
-      handleMovingState(event);
-      break;
-    case ObjState::Jumping:
-      handleJumpingState(event);
-      break;
-    case ObjState::Firing:
-      handleFiringState(event);
-      break;
-    case ObjState::FiringAndMoving:
-      handleFiringAndMovingState(event);
-      break;
-    case ObjState::FiringAndJumping:
-      handleFiringAndJumpingState(event);
-      break;
-    default:
-      break;
+void Player::update(const Uint32 &dt, const Span<const TickEvent> &events) {
+  PROFILE_SCOPE("Player::update");
+  storePreviousDestination();
+
+  // Handle events, moving up to the moment of each one before it changes
+  // the motion. Events sharing a moment don't move the player in between,
+  // or a take off would be clamped back to the floor.
+  float elapsed = 0.0f;
+  for (const auto &input : events) {
+    const float offset = std::min(std::max(input.offset, elapsed), float(dt));
+    if (offset > elapsed) {
+      integrate(offset - elapsed);
+      elapsed = offset;
     }
+    land();
+    applyEvent(input.event);
+  }
+
+  if (float(dt) > elapsed) {
+    integrate(float(dt) - elapsed);
   }
+  land();
 
   // Update bullet timer
   if (isFiring()) {
@@ -46,8 +42,7 @@ void Player::update(const Uint32 &dt, const std::vector<KbdEvents> &events) {
     m_bulletTimer = 0;
   }
 
-  // Parent class update
-  DynamicObject::update(dt);
+  updateAnimation(dt);
 }
 
 bool Player::shouldSpawnBullet() {
@@ -58,178 +53,47 @@ bool Player::shouldSpawnBullet() {
   return false;
 }
 
-bool Player::isFiring() {
-  return getState() == ObjState::Firing ||
-         getState() == ObjState::FiringAndMoving ||
-         getState() == ObjState::FiringAndJumping;
+void Player::hashState(StateHash &hash) const {
+#ifdef FIXED_POINT_PHYSICS
+  hash.add(getFixedDestination());
+  hash.add(getFixedVelocity());
+#else
+  hash.add(getDestination());
+  hash.add(getVelocityX());
+  hash.add(getVelocityY());
+#endif
+  hash.add(getState());
+  hash.add(m_health);
+  hash.add(m_bulletTimer);
 }
 
-void Player::handleIdleState(const KbdEvents event) {
-  switch (event) {
-  case KbdEvents::Left_KeyDown:
-  case KbdEvents::Right_KeyDown: {
-    setState(ObjState::Moving);
-    const float vx = event == KbdEvents::Left_KeyDown ? -0.001f : 0.001f;
-    setVelocityX(vx);
-    break;
-  }
-  case KbdEvents::Space_KeyDown: {
-    setState(ObjState::Jumping);
-    setVelocityY(-0.005f);
-    break;
-  }
-  case KbdEvents::LCtrl_KeyDown: {
-    setState(ObjState::Firing);
-    m_bulletTimer = 0;
-  }
-  default:
-    break;
-  }
-}
+bool Player::isFiring() const { return isFiringState(getState()); }
 
-void Player::handleMovingState(const KbdEvents event) {
-  switch (event) {
-  case KbdEvents::Left_KeyDown:
-  case KbdEvents::Right_KeyDown: {
-    setState(ObjState::Moving);
-    const float vx = event == KbdEvents::Left_KeyDown ? -0.001f : 0.001f;
-    setVelocityX(vx);
+void Player::applyEvent(const KbdEvents event) {
+  const StateTransition &transition = getTransition(getState(), event);
+  setState(transition.next);
+  switch (transition.horizontal) {
+  case HorizontalAction::RunLeft:
+    setVelocityX(-PlayerRunSpeed);
     break;
-  }
-  case KbdEvents::Left_KeyUp:
-  case KbdEvents::Right_KeyUp: {
-    setState(ObjState::Idle);
-    setVelocityX(0.0f);
+  case HorizontalAction::RunRight:
+    setVelocityX(PlayerRunSpeed);
     break;
-  }
-  case KbdEvents::Space_KeyDown: {
-    setState(ObjState::Jumping);
-    setVelocityY(-0.005f);
-    break;
-  }
-  case KbdEvents::LCtrl_KeyDown: {
-    setState(ObjState::FiringAndMoving);
-  }
-  default:
-    break;
-  }
-}
-
-void Player::handleJumpingState(const KbdEvents event) {
-  switch (event) {
-  case KbdEvents::Left_KeyDown:
-  case KbdEvents::Right_KeyDown: {
-    const float vx = event == KbdEvents::Left_KeyDown ? -0.001f : 0.001f;
-    setVelocityX(vx);
-    break;
-  }
-  case KbdEvents::Left_KeyUp:
-  case KbdEvents::Right_KeyUp: {
+  case HorizontalAction::Stop:
     setVelocityX(0.0f);
     break;
-  }
-    // TODO: enable double jump later
-    //   case KbdEvents::Space_KeyDown: {
-    //     setState(ObjState::Jumping);
-    //     setVelocityY(-0.005f);
-    //     break;
-    //   }
-  case KbdEvents::LCtrl_KeyDown: {
-    setState(ObjState::FiringAndJumping);
-  }
-  default:
+  case HorizontalAction::Keep:
     break;
   }
-  if (getOppositeY() == Global::Game::Floor) {
-    if (getVelocityX() == 0) {
-      setState(ObjState::Idle);
-    } else {
-      setState(ObjState::Moving);
-    }
+  if (transition.jump) {
+    setVelocityY(-PlayerJumpSpeed);
   }
 }
 
-void Player::handleFiringState(const KbdEvents event) {
-  switch (event) {
-  case KbdEvents::Left_KeyDown:
-  case KbdEvents::Right_KeyDown: {
-    setState(ObjState::FiringAndMoving);
-    const float vx = event == KbdEvents::Left_KeyDown ? -0.001f : 0.001f;
-    setVelocityX(vx);
-    break;
-  }
-  case KbdEvents::Space_KeyDown: {
-    setState(ObjState::FiringAndJumping);
-    setVelocityY(-0.005f);
-    break;
-  }
-  case KbdEvents::LCtrl_KeyUp: {
-    setState(ObjState::Idle);
-  }
-  default:
-    break;
-  }
-}
-
-void Player::handleFiringAndMovingState(const KbdEvents event) {
-  switch (event) {
-  case KbdEvents::Left_KeyDown:
-  case KbdEvents::Right_KeyDown: {
-    setState(ObjState::FiringAndMoving);
-    const float vx = event == KbdEvents::Left_KeyDown ? -0.001f : 0.001f;
-    setVelocityX(vx);
-    break;
-  }
-  case KbdEvents::Left_KeyUp:
-  case KbdEvents::Right_KeyUp: {
-    setState(ObjState::Firing);
-    setVelocityX(0.0f);
-    break;
-  }
-  case KbdEvents::Space_KeyDown: {
-    setState(ObjState::FiringAndJumping);
-    setVelocityY(-0.005f);
-    break;
-  }
-  case KbdEvents::LCtrl_KeyUp: {
-    setState(ObjState::Moving);
-  }
-  default:
-    break;
-  }
-}
-
-void Player::handleFiringAndJumpingState(const KbdEvents event) {
-  switch (event) {
-  case KbdEvents::Left_KeyDown:
-  case KbdEvents::Right_KeyDown: {
-    const float vx = event == KbdEvents::Left_KeyDown ? -0.001f : 0.001f;
-    setVelocityX(vx);
-    break;
-  }
-  case KbdEvents::Left_KeyUp:
-  case KbdEvents::Right_KeyUp: {
-    setVelocityX(0.0f);
-    break;
-  }
-    // TODO: enable double jump later
-    //   case KbdEvents::Space_KeyDown: {
-    //     setState(ObjState::Jumping);
-    //     setVelocityY(-0.005f);
-    //     break;
-    //   }
-  case KbdEvents::LCtrl_KeyUp: {
-    setState(ObjState::Jumping);
-  }
-  default:
-    break;
-  }
-  if (getOppositeY() == Global::Game::Floor) {
-    if (getVelocityX() == 0) {
-      setState(ObjState::Firing);
-    } else {
-      setState(ObjState::FiringAndMoving);
-    }
+void Player::land() {
+  // Still on the ground at take off, the jump has not started yet
+  if (isOnFloor() && getVelocityY() >= 0.0f) {
+    setState(getLandedState(getState(), getVelocityX() != 0.0f));
   }
 }
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Components_forward.h"
+#include <array>
+
+// Player state machine as a table indexed by state and event, built at
+// compile time. A player state combines whether it fires with how it moves,
+// and each key only changes one of the two: arrows pick the running
+// direction, space jumps from the ground and left ctrl holds fire.
+
+const float PlayerRunSpeed = 0.001f; // horizontal, per ms
+const float PlayerJumpSpeed = 0.005f; // vertical at take off, per ms
+
+enum class HorizontalAction { Keep, RunLeft, RunRight, Stop };
+
+struct StateTransition {
+  ObjState next;
+  HorizontalAction horizontal;
+  bool jump; // takes off with PlayerJumpSpeed
+};
+
+using PlayerTransitionTable =
+    std::array<std::array<StateTransition, KbdEventCount>, ObjStateCount>;
+
+enum class Motion { Idle, Moving, Jumping };
+
+constexpr bool isFiringState(const ObjState state) {
+  return state == ObjState::Firing || state == ObjState::FiringAndMoving ||
+         state == ObjState::FiringAndJumping;
+}
+
+constexpr Motion getMotion(const ObjState state) {
+  return state == ObjState::Moving || state == ObjState::FiringAndMoving
+             ? Motion::Moving
+         : state == ObjState::Jumping || state == ObjState::FiringAndJumping
+             ? Motion::Jumping
+             : Motion::Idle;
+}
+
+constexpr ObjState makeState(const bool firing, const Motion motion) {
+  return motion == Motion::Moving
+             ? (firing ? ObjState::FiringAndMoving : ObjState::Moving)
+         : motion == Motion::Jumping
+             ? (firing ? ObjState::FiringAndJumping : ObjState::Jumping)
+             : (firing ? ObjState::Firing : ObjState::Idle);
+}
+
+constexpr StateTransition makeTransition(const ObjState state,
+                                         const KbdEvents event) {
+  const bool firing = isFiringState(state);
+  const Motion motion = getMotion(state);
+  // Only ground motions change with the arrows, jumps keep their arc
+  const Motion run = motion == Motion::Jumping ? motion : Motion::Moving;
+  const Motion stop = motion == Motion::Jumping ? motion : Motion::Idle;
+  switch (event) {
+  case KbdEvents::Left_KeyDown:
+    return {makeState(firing, run), HorizontalAction::RunLeft, false};
+  case KbdEvents::Right_KeyDown:
+    return {makeState(firing, run), HorizontalAction::RunRight, false};
+  case KbdEvents::Left_KeyUp:
+  case KbdEvents::Right_KeyUp:
+    // Idle players are not running, nothing to stop
+    return motion == Motion::Idle
+               ? StateTransition{state, HorizontalAction::Keep, false}
+               : StateTransition{makeState(firing, stop),
+                                 HorizontalAction::Stop, false};
+  case KbdEvents::Space_KeyDown:
+    // No double jump
+    return motion == Motion::Jumping
+               ? StateTransition{state, HorizontalAction::Keep, false}
+               : StateTransition{makeState(firing, Motion::Jumping),
+                                 HorizontalAction::Keep, true};
+  case KbdEvents::LCtrl_KeyDown:
+    return {makeState(true, motion), HorizontalAction::Keep, false};
+  case KbdEvents::LCtrl_KeyUp:
+    return {makeState(false, motion), HorizontalAction::Keep, false};
+  default:
+    return {state, HorizontalAction::Keep, false};
+  }
+}
+
+constexpr PlayerTransitionTable makePlayerTransitions() {
+  PlayerTransitionTable table{};
+  for (unsigned int state = 0; state < ObjStateCount; ++state) {
+    for (unsigned int event = 0; event < KbdEventCount; ++event) {
+      table[state][event] =
+          makeTransition(ObjState(state), KbdEvents(event));
+    }
+  }
+  return table;
+}
+
+constexpr PlayerTransitionTable PlayerTransitions = makePlayerTransitions();
+
+constexpr const StateTransition &getTransition(const ObjState state,
+                                               const KbdEvents event) {
+  return PlayerTransitions[unsigned(state)][unsigned(event)];
+}
+
+// State once a jump touches the ground
+constexpr ObjState getLandedState(const ObjState state, const bool running) {
+  return getMotion(state) != Motion::Jumping
+             ? state
+             : makeState(isFiringState(state),
+                         running ? Motion::Moving : Motion::Idle);
+}
+
+// Spot checks of the table against the intended behaviour
+static_assert(getTransition(ObjState::Idle, KbdEvents::LCtrl_KeyDown).next ==
+                  ObjState::Firing,
+              "holding fire from idle fires");
+static_assert(getTransition(ObjState::FiringAndMoving, KbdEvents::Left_KeyUp)
+                      .next == ObjState::Firing,
+              "releasing an arrow stops running but keeps firing");
+static_assert(getTransition(ObjState::Jumping, KbdEvents::Space_KeyDown)
+                      .next == ObjState::Jumping &&
+                  !getTransition(ObjState::Jumping, KbdEvents::Space_KeyDown)
+                       .jump,
+              "no double jump");
+static_assert(getTransition(ObjState::FiringAndJumping,
+                            KbdEvents::Right_KeyDown)
+                      .next == ObjState::FiringAndJumping,
+              "arrows steer jumps without leaving them");
+static_assert(getTransition(ObjState::Moving, KbdEvents::Up_KeyDown).next ==
+                      ObjState::Moving &&
+                  getTransition(ObjState::Moving, KbdEvents::Up_KeyDown)
+                          .horizontal == HorizontalAction::Keep,
+              "up and down do nothing yet");
+static_assert(getLandedState(ObjState::FiringAndJumping, false) ==
+                  ObjState::Firing,
+              "landing keeps fire");
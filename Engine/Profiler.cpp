@@ -0,0 +1,138 @@
+#include "Profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Fields are atomic so that a trace can be written while threads keep
+// recording, relaxed accesses cost the same as plain ones
+struct ProfileEvent {
+  std::atomic<const char *> name{nullptr};
+  std::atomic<Uint64> start{0};
+  std::atomic<Uint64> end{0};
+};
+
+// Written by its thread only. Once full, new scopes overwrite the oldest.
+struct ProfileBuffer {
+  std::array<ProfileEvent, ProfileBufferCapacity> events;
+  std::atomic<Uint64> written{0};
+  std::atomic<const char *> threadName{nullptr};
+};
+
+struct TraceEvent {
+  const char *name;
+  Uint64 start;
+  Uint64 end;
+};
+
+// Buffers outlive their threads, so finished threads still show up
+std::mutex buffersMutex;
+std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+
+ProfileBuffer &threadBuffer() {
+  thread_local ProfileBuffer *buffer = nullptr;
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.emplace_back(new ProfileBuffer());
+    buffer = buffers.back().get();
+  }
+  return *buffer;
+}
+
+// Copies the scopes a buffer holds, leaving out those overwritten while
+// copying
+void readBuffer(const ProfileBuffer &buffer, std::vector<TraceEvent> &out) {
+  out.clear();
+  const Uint64 written = buffer.written.load(std::memory_order_acquire);
+  Uint64 first =
+      written > ProfileBufferCapacity ? written - ProfileBufferCapacity : 0;
+  for (Uint64 i = first; i < written; ++i) {
+    const ProfileEvent &event = buffer.events[i % ProfileBufferCapacity];
+    out.push_back({event.name.load(std::memory_order_relaxed),
+                   event.start.load(std::memory_order_relaxed),
+                   event.end.load(std::memory_order_relaxed)});
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const Uint64 after = buffer.written.load(std::memory_order_relaxed);
+  if (after + 1 > first + ProfileBufferCapacity) {
+    const Uint64 overwritten = after + 1 - ProfileBufferCapacity - first;
+    out.erase(out.begin(), out.begin() + std::min<Uint64>(overwritten,
+                                                          out.size()));
+  }
+}
+
+} // namespace
+
+// PROFILER START
+void Profiler::record(const char *name, const Uint64 start,
+                      const Uint64 end) {
+  ProfileBuffer &buffer = threadBuffer();
+  const Uint64 position = buffer.written.load(std::memory_order_relaxed);
+  // Pairs with the fence of readBuffer: a reader that sees any of these
+  // writes also sees that the slot was reused
+  std::atomic_thread_fence(std::memory_order_release);
+  ProfileEvent &event = buffer.events[position % ProfileBufferCapacity];
+  event.name.store(name, std::memory_order_relaxed);
+  event.start.store(start, std::memory_order_relaxed);
+  event.end.store(end, std::memory_order_relaxed);
+  buffer.written.store(position + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char *name) {
+  threadBuffer().threadName.store(name, std::memory_order_relaxed);
+}
+
+bool Profiler::writeTrace(const std::string &filePath) {
+  std::ofstream file(filePath);
+  if (!file) {
+    std::cout << "Couldn't create trace " << filePath << std::endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  std::vector<std::vector<TraceEvent>> threads(buffers.size());
+  Uint64 origin = ~Uint64(0);
+  for (std::size_t i = 0; i < buffers.size(); ++i) {
+    readBuffer(*buffers[i], threads[i]);
+    for (const auto &event : threads[i]) {
+      origin = std::min(origin, event.start);
+    }
+  }
+
+  // Timestamps in microseconds since the oldest scope
+  const double usPerCount = 1e6 / SDL_GetPerformanceFrequency();
+  file << "{\"traceEvents\":[";
+  const char *separator = "\n";
+  file.setf(std::ios::fixed);
+  file.precision(3);
+  for (std::size_t i = 0; i < threads.size(); ++i) {
+    if (const char *name = buffers[i]->threadName.load()) {
+      file << separator << "{\"name\":\"thread_name\",\"ph\":\"M\","
+           << "\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\"" << name
+           << "\"}}";
+      separator = ",\n";
+    }
+    for (const auto &event : threads[i]) {
+      file << separator << "{\"name\":\"" << event.name
+           << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << i
+           << ",\"ts\":" << (event.start - origin) * usPerCount
+           << ",\"dur\":" << (event.end - event.start) * usPerCount << "}";
+      separator = ",\n";
+    }
+  }
+  file << "\n]}\n";
+  std::cout << "Trace written to " << filePath << std::endl;
+  return bool(file);
+}
+// PROFILER END
+
+#endif
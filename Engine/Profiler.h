@@ -0,0 +1,52 @@
+#pragma once
+
+// Scoped profiler recording into a ring buffer per thread, written out as
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev). Only built with
+// ENABLE_PROFILER defined, the macros expand to nothing otherwise.
+//   PROFILE_SCOPE(name)      times the rest of the enclosing block
+//   PROFILE_THREAD(name)     names the calling thread in the trace
+//   PROFILE_WRITE(filePath)  writes what the buffers hold
+// Names must be string literals, only their address is recorded.
+#ifdef ENABLE_PROFILER
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <string>
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name)                                                  \
+  const ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#define PROFILE_WRITE(filePath) Profiler::writeTrace(filePath)
+
+const std::size_t ProfileBufferCapacity = 1 << 15; // scopes kept per thread
+
+namespace Profiler {
+void record(const char *name, const Uint64 start, const Uint64 end);
+void setThreadName(const char *name);
+bool writeTrace(const std::string &filePath);
+} // namespace Profiler
+
+class ProfileScope {
+public:
+  explicit ProfileScope(const char *name)
+      : m_name(name), m_start(SDL_GetPerformanceCounter()) {}
+  ~ProfileScope() {
+    Profiler::record(m_name, m_start, SDL_GetPerformanceCounter());
+  }
+  ProfileScope(const ProfileScope &) = delete;            // no copy
+  ProfileScope &operator=(const ProfileScope &) = delete; // no copy-assignment
+
+private:
+  const char *m_name;
+  Uint64 m_start;
+};
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+#define PROFILE_WRITE(filePath)
+
+#endif
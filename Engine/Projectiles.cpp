@@ -0,0 +1,228 @@
+#include "Projectiles.h"
+#include "../Game/Definitions.h"
+#include "Profiler.h"
+#include <cmath>
+
+// PROJECTILE POOL START
+ProjectilePool::ProjectilePool(const std::size_t capacity) {
+  setCapacity(capacity);
+}
+
+void ProjectilePool::setCapacity(const std::size_t capacity) {
+  m_posX.resize(capacity);
+  m_posY.resize(capacity);
+  m_prevX.resize(capacity);
+  m_prevY.resize(capacity);
+  m_velX.resize(capacity);
+  m_velY.resize(capacity);
+  m_lifeSpans.resize(capacity);
+  m_ages.resize(capacity);
+  m_damages.resize(capacity);
+#ifdef FIXED_POINT_PHYSICS
+  m_fixedX.resize(capacity);
+  m_fixedY.resize(capacity);
+  m_fixedVx.resize(capacity);
+  m_fixedVy.resize(capacity);
+#endif
+  m_capacity = capacity;
+  if (m_size > m_capacity) {
+    m_size = m_capacity;
+  }
+}
+
+bool ProjectilePool::spawn(const float x, const float y, const float vx,
+                           const float vy) {
+  if (full()) {
+    return false;
+  }
+#ifdef FIXED_POINT_PHYSICS
+  m_fixedX[m_size] = toFixedX(x);
+  m_fixedY[m_size] = toFixedY(y);
+  m_fixedVx[m_size] = toFixedX(vx);
+  m_fixedVy[m_size] = toFixedY(vy);
+  m_posX[m_size] = toNormalizedX(m_fixedX[m_size]);
+  m_posY[m_size] = toNormalizedY(m_fixedY[m_size]);
+  m_velX[m_size] = toNormalizedX(m_fixedVx[m_size]);
+  m_velY[m_size] = toNormalizedY(m_fixedVy[m_size]);
+#else
+  m_posX[m_size] = x;
+  m_posY[m_size] = y;
+  m_velX[m_size] = vx;
+  m_velY[m_size] = vy;
+#endif
+  m_prevX[m_size] = m_posX[m_size];
+  m_prevY[m_size] = m_posY[m_size];
+  m_lifeSpans[m_size] = m_lifeSpan;
+  m_ages[m_size] = 0;
+  m_damages[m_size] = m_damage;
+  ++m_size;
+  return true;
+}
+
+void ProjectilePool::update(const Uint32 &dt, JobSystem *jobs) {
+  PROFILE_SCOPE("ProjectilePool::update");
+#ifdef FIXED_POINT_PHYSICS
+  const Fixed step = toFixed(float(dt));
+  const Fixed floor = getFixedFloor() - toFixedY(m_height);
+  const Fixed gravity = fixedMul(getFixedGravity(), step);
+#else
+  const float floor = Global::Game::Floor - m_height;
+#endif
+  parallelFor(jobs, m_size, Global::Jobs::ChunkSize,
+              [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                  m_prevX[i] = m_posX[i];
+                  m_prevY[i] = m_posY[i];
+#ifdef FIXED_POINT_PHYSICS
+                  m_fixedX[i] += fixedMul(m_fixedVx[i], step);
+                  m_fixedY[i] += fixedMul(m_fixedVy[i], step);
+                  if (m_fixedY[i] >= floor) {
+                    m_fixedY[i] = floor;
+                    m_fixedVy[i] = 0;
+                  } else if (m_gravitySensitive) {
+                    m_fixedVy[i] += gravity;
+                  }
+                  m_posX[i] = toNormalizedX(m_fixedX[i]);
+                  m_posY[i] = toNormalizedY(m_fixedY[i]);
+                  m_velY[i] = toNormalizedY(m_fixedVy[i]);
+#else
+                  m_posX[i] += m_velX[i] * dt;
+                  m_posY[i] += m_velY[i] * dt;
+                  if (m_posY[i] >= floor) {
+                    m_posY[i] = floor;
+                    m_velY[i] = 0.0f;
+                  } else if (m_gravitySensitive) {
+                    m_velY[i] += Global::Game::Gravity * dt;
+                  }
+#endif
+                }
+
+                for (std::size_t i = begin; i < end; ++i) {
+                  m_ages[i] += dt;
+                  m_lifeSpans[i] =
+                      m_lifeSpans[i] <= dt ? 0 : m_lifeSpans[i] - dt;
+                }
+              });
+}
+
+void ProjectilePool::render(RenderSnapshot &snapshot) {
+  if (!m_clip) {
+    return;
+  }
+  for (std::size_t i = 0; i < m_size; ++i) {
+    m_clip->renderAt(snapshot, getPreviousDestination(i), getDestination(i),
+                     m_ages[i]);
+  }
+}
+
+void ProjectilePool::addColliders(SpatialHashGrid &grid, const Uint32 layer,
+                                  const Uint32 mask) const {
+  for (std::size_t i = 0; i < m_size; ++i) {
+    if (m_lifeSpans[i] != 0) {
+      grid.addCollider(getPreviousDestination(i), getDestination(i), layer,
+                       mask, i);
+    }
+  }
+}
+
+void ProjectilePool::removeDead() {
+  std::size_t i = 0;
+  while (i < m_size) {
+    if (m_lifeSpans[i] == 0) {
+      --m_size;
+      moveBullet(m_size, i);
+    } else {
+      ++i;
+    }
+  }
+}
+
+void ProjectilePool::hashState(StateHash &hash) const {
+  hash.add(m_size);
+#ifdef FIXED_POINT_PHYSICS
+  hash.add(m_fixedX, m_size);
+  hash.add(m_fixedY, m_size);
+  hash.add(m_fixedVx, m_size);
+  hash.add(m_fixedVy, m_size);
+#else
+  hash.add(m_posX, m_size);
+  hash.add(m_posY, m_size);
+  hash.add(m_velX, m_size);
+  hash.add(m_velY, m_size);
+#endif
+  hash.add(m_lifeSpans, m_size);
+  hash.add(m_damages, m_size);
+}
+
+void ProjectilePool::moveBullet(const std::size_t from, const std::size_t to) {
+  m_posX[to] = m_posX[from];
+  m_posY[to] = m_posY[from];
+  m_prevX[to] = m_prevX[from];
+  m_prevY[to] = m_prevY[from];
+  m_velX[to] = m_velX[from];
+  m_velY[to] = m_velY[from];
+  m_lifeSpans[to] = m_lifeSpans[from];
+  m_ages[to] = m_ages[from];
+  m_damages[to] = m_damages[from];
+#ifdef FIXED_POINT_PHYSICS
+  m_fixedX[to] = m_fixedX[from];
+  m_fixedY[to] = m_fixedY[from];
+  m_fixedVx[to] = m_fixedVx[from];
+  m_fixedVy[to] = m_fixedVy[from];
+#endif
+}
+// PROJECTILE POOL END
+
+// BULLET EMITTER START
+BulletEmitter::BulletEmitter(const EmitterPattern pattern,
+                             const unsigned int count, const float speed,
+                             const float arc, const float spin)
+    : m_pattern(pattern), m_count(count), m_speed(speed), m_arc(arc),
+      m_spin(spin) {}
+
+unsigned int BulletEmitter::emit(ProjectilePool &pool, const float x,
+                                 const float y, const float direction) {
+  if (m_count == 0) {
+    return 0;
+  }
+
+  // Angle of the first bullet and the step between consecutive bullets
+  const float fullCircle = 6.28318531f;
+  float first = direction;
+  float step = 0.0f;
+  switch (m_pattern) {
+  case EmitterPattern::Spread:
+    if (m_count > 1) {
+      first = direction - m_arc / 2;
+      step = m_arc / (m_count - 1);
+    }
+    break;
+  case EmitterPattern::Ring:
+    step = fullCircle / m_count;
+    break;
+  case EmitterPattern::Spiral:
+    first = direction + m_angle;
+    step = fullCircle / m_count;
+    m_angle = std::fmod(m_angle + m_spin, fullCircle);
+    break;
+  default:
+    break;
+  }
+
+  // Positions are normalized to the screen size, so the vertical speed is
+  // corrected to keep the angles right on a non-square screen
+  const float aspect =
+      float(Global::SDL::ScreenWidth) / float(Global::SDL::ScreenHeight);
+  unsigned int spawned = 0;
+  for (unsigned int i = 0; i < m_count; ++i) {
+    const float angle = first + step * i;
+    const float vx = m_speed * std::cos(angle);
+    const float vy = m_speed * std::sin(angle) * aspect;
+    if (!pool.spawn(x, y, vx, vy)) {
+      break;
+    }
+    ++spawned;
+  }
+  return spawned;
+}
+// BULLET EMITTER END
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Collision.h"
+#include "Components.h"
+#include "Components_forward.h"
+#include "FixedPoint.h"
+#include "JobSystem.h"
+#include "StateHash.h"
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity projectile storage. Every attribute lives in its own
+// contiguous array and spawn/despawn never allocate: bullets are appended at
+// the end and dead bullets are swapped with the last live one.
+class ProjectilePool {
+public:
+  ProjectilePool() = default;
+  ProjectilePool(const std::size_t capacity);
+
+public:
+  bool spawn(const float x, const float y, const float vx, const float vy);
+  void update(const Uint32 &dt, JobSystem *jobs = nullptr);
+  void render(RenderSnapshot &snapshot);
+  void addColliders(SpatialHashGrid &grid, const Uint32 layer,
+                    const Uint32 mask) const;
+  void hitted(const std::size_t index) { m_lifeSpans[index] = 0; }
+  void removeDead();
+  void hashState(StateHash &hash) const;
+  void clear() { m_size = 0; }
+
+  // Setters
+  void setCapacity(const std::size_t capacity);
+  void setSize(const float w, const float h) {
+    m_width = w;
+    m_height = h;
+  }
+  void setDamage(const int damage) { m_damage = damage; }
+  void setLifeSpan(const Uint32 &lifeSpan) { m_lifeSpan = lifeSpan; }
+  void setGravitySensitive(const bool gravStv) { m_gravitySensitive = gravStv; }
+  void setAnimation(const AnimationClip &clip) { m_clip = &clip; }
+
+  // Getters
+  std::size_t size() const { return m_size; }
+  std::size_t capacity() const { return m_capacity; }
+  bool full() const { return m_size == m_capacity; }
+  bool isAlive(const std::size_t index) const {
+    return m_lifeSpans[index] != 0;
+  }
+  const Rectf getDestination(const std::size_t index) const {
+    return {m_posX[index], m_posY[index], m_width, m_height};
+  }
+  const Rectf getPreviousDestination(const std::size_t index) const {
+    return {m_prevX[index], m_prevY[index], m_width, m_height};
+  }
+  int getDamage(const std::size_t index) const { return m_damages[index]; }
+
+private:
+  void moveBullet(const std::size_t from, const std::size_t to);
+
+private:
+  // Per bullet data
+  std::vector<float> m_posX;
+  std::vector<float> m_posY;
+  std::vector<float> m_prevX; // position before the last update
+  std::vector<float> m_prevY;
+  std::vector<float> m_velX;
+  std::vector<float> m_velY;
+  std::vector<Uint32> m_lifeSpans;
+  std::vector<Uint32> m_ages;
+  std::vector<int> m_damages;
+#ifdef FIXED_POINT_PHYSICS
+  // The physics run on these, the float positions and velocities follow
+  std::vector<Fixed> m_fixedX; // pixels
+  std::vector<Fixed> m_fixedY;
+  std::vector<Fixed> m_fixedVx; // pixels per ms
+  std::vector<Fixed> m_fixedVy;
+#endif
+  std::size_t m_size = 0;
+  std::size_t m_capacity = 0;
+
+  // Shared by every bullet of the pool
+  const AnimationClip *m_clip = nullptr;
+  float m_width = 0.0f;
+  float m_height = 0.0f;
+  int m_damage = 0;
+  Uint32 m_lifeSpan = 0;
+  bool m_gravitySensitive = false;
+};
+
+enum class EmitterPattern {
+  Spread, // bullets fanned over an arc around the firing direction
+  Ring,   // bullets evenly distributed over a full circle
+  Spiral  // ring that rotates a bit more on every emission
+};
+
+// Spawns groups of bullets into a pool every time the owner fires.
+// Directions are in radians, 0 points right and angles grow clockwise.
+class BulletEmitter {
+public:
+  BulletEmitter() = default;
+  BulletEmitter(const EmitterPattern pattern, const unsigned int count,
+                const float speed, const float arc = 0.0f,
+                const float spin = 0.0f);
+
+public:
+  unsigned int emit(ProjectilePool &pool, const float x, const float y,
+                    const float direction = 0.0f);
+
+  // Setters
+  void setPattern(const EmitterPattern pattern) { m_pattern = pattern; }
+  void setCount(const unsigned int count) { m_count = count; }
+  void setSpeed(const float speed) { m_speed = speed; }
+  void setArc(const float arc) { m_arc = arc; }
+  void setSpin(const float spin) { m_spin = spin; }
+
+private:
+  EmitterPattern m_pattern = EmitterPattern::Spread;
+  unsigned int m_count = 1;
+  float m_speed = 0.0f;
+  float m_arc = 0.0f;   // spread pattern only
+  float m_spin = 0.0f;  // spiral pattern only
+  float m_angle = 0.0f; // current spiral rotation
+};
@@ -0,0 +1,34 @@
+#include "RenderSnapshot.h"
+
+// RENDER SNAPSHOT START
+void RenderSnapshot::render(SpriteBatch &batch, TextureManager &textures,
+                            const float alpha) const {
+  Uint32 slot = TextureHandle::NoSlot;
+  const ResidentTexture *texture = nullptr;
+  for (const auto &sprite : m_sprites) {
+    // Sprites of the same image come in runs, resolve once per run
+    if (sprite.texture != slot) {
+      slot = sprite.texture;
+      texture = textures.Resolve(slot);
+    }
+    if (!texture) {
+      continue;
+    }
+    const Rectf &a = sprite.previous;
+    const Rectf &b = sprite.current;
+    batch.addSprite(*texture, sprite.source,
+                    {a.x + (b.x - a.x) * alpha, a.y + (b.y - a.y) * alpha,
+                     a.w + (b.w - a.w) * alpha, a.h + (b.h - a.h) * alpha});
+  }
+}
+
+float RenderSnapshot::getAlpha(const Uint64 now) const {
+  if (now <= m_time) {
+    return 0.0f;
+  }
+  if (now - m_time >= m_interval) {
+    return 1.0f;
+  }
+  return float(double(now - m_time) / double(m_interval));
+}
+// RENDER SNAPSHOT END
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Components_forward.h"
+#include "SpriteBatch.h"
+#include "TextureManager.h"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Textures are image slots of the texture manager, resolved when drawing.
+// Destinations are normalized, as on the previous and on the current model
+// update.
+struct Sprite {
+  Uint32 texture;
+  SDL_Rect source;
+  Rectf previous;
+  Rectf current;
+};
+
+// Everything needed to draw one model state, in drawing order. Built by the
+// simulation and drawn by the render loop without touching game objects.
+// The render loop draws sprites between their previous and current
+// destinations, according to how far it is into the model update.
+class RenderSnapshot {
+public:
+  RenderSnapshot() = default;
+
+public:
+  void clear() { m_sprites.clear(); }
+  void addSprite(const Uint32 texture, const SDL_Rect &source,
+                 const Rectf &previous, const Rectf &current) {
+    m_sprites.push_back({texture, source, previous, current});
+  }
+  void render(SpriteBatch &batch, TextureManager &textures,
+              const float alpha) const;
+
+  // Setters
+  void setTiming(const Uint64 time, const Uint64 interval) {
+    m_time = time;
+    m_interval = interval;
+  }
+
+  // Getters
+  float getAlpha(const Uint64 now) const;
+  std::size_t size() const { return m_sprites.size(); }
+
+private:
+  std::vector<Sprite> m_sprites;
+  Uint64 m_time = 0;     // performance counter when the update was due
+  Uint64 m_interval = 1; // performance counts between updates
+};
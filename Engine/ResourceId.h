@@ -0,0 +1,40 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <string>
+
+// FNV-1a of the name a resource is loaded from
+constexpr Uint32 hashResourceName(const char *name) {
+  Uint32 hash = 2166136261u;
+  while (*name != '\0') {
+    hash = (hash ^ Uint8(*name++)) * 16777619u;
+  }
+  return hash;
+}
+
+// Typed id of a resource: the hash of the path it is loaded from. The tag
+// keeps ids of different kinds of resources apart.
+template <typename Tag> class ResourceId {
+public:
+  constexpr ResourceId() = default;
+  constexpr explicit ResourceId(const char *name)
+      : m_value(hashResourceName(name)) {}
+  explicit ResourceId(const std::string &name) : ResourceId(name.c_str()) {}
+
+public:
+  constexpr bool operator==(const ResourceId &other) const {
+    return m_value == other.m_value;
+  }
+  constexpr bool operator!=(const ResourceId &other) const {
+    return m_value != other.m_value;
+  }
+
+  // Getters
+  constexpr Uint32 getValue() const { return m_value; }
+
+private:
+  Uint32 m_value = 0;
+};
+
+struct TextureTag;
+using TextureId = ResourceId<TextureTag>;
@@ -0,0 +1,99 @@
+#include "Scheduler.h"
+#include <algorithm>
+
+// SCHEDULER START
+Scheduler::Scheduler() : Scheduler(10.0) {}
+
+Scheduler::Scheduler(const double rate, const unsigned int maxCatchUp)
+    : m_frequency(SDL_GetPerformanceFrequency()), m_maxCatchUp(maxCatchUp) {
+  setRate(rate);
+}
+
+void Scheduler::setRate(const double rate) {
+  m_step = std::max(Uint64(m_frequency / rate), Uint64(1));
+  m_oversleep = m_frequency / 1000;
+  reset();
+}
+
+void Scheduler::reset() {
+  m_nextStep = SDL_GetPerformanceCounter();
+  m_jitter = JitterStats();
+  m_totalLatenessMs = 0.0;
+}
+
+unsigned int Scheduler::advance() {
+  const Uint64 now = SDL_GetPerformanceCounter();
+  if (now < m_nextStep) {
+    return 0;
+  }
+
+  const double latenessMs = toMs(now - m_nextStep);
+  ++m_jitter.wakeUps;
+  m_totalLatenessMs += latenessMs;
+  m_jitter.meanMs = m_totalLatenessMs / m_jitter.wakeUps;
+  m_jitter.maxMs = std::max(m_jitter.maxMs, latenessMs);
+
+  // Steps missed beyond the catch-up limit are dropped, so a long hitch
+  // cannot snowball into ever longer catch-up bursts
+  Uint64 due = (now - m_nextStep) / m_step + 1;
+  if (due > m_maxCatchUp) {
+    m_jitter.dropped += due - m_maxCatchUp;
+    m_nextStep += (due - m_maxCatchUp) * m_step;
+    due = m_maxCatchUp;
+  }
+  m_nextStep += due * m_step;
+  m_jitter.steps += due;
+  return due;
+}
+
+void Scheduler::waitForNextStep(const double maxWaitMs) {
+  const Uint64 start = SDL_GetPerformanceCounter();
+  const Uint64 deadline = m_nextStep;
+  if (start >= deadline) {
+    return;
+  }
+
+  // Callers polling something else meanwhile only need a coarse nap
+  const Uint64 msCounts = m_frequency / 1000;
+  const Uint64 remaining = deadline - start;
+  if (maxWaitMs > 0.0 && remaining > Uint64(maxWaitMs * msCounts) +
+                                         m_oversleep) {
+    SDL_Delay(Uint32(maxWaitMs));
+    return;
+  }
+
+  // Sleep while the deadline is further than the worst oversleep seen
+  if (remaining > m_oversleep + msCounts) {
+    const Uint32 sleepMs = Uint32((remaining - m_oversleep) / msCounts);
+    SDL_Delay(sleepMs);
+    const Uint64 slept = SDL_GetPerformanceCounter() - start;
+    const Uint64 requested = sleepMs * msCounts;
+    const Uint64 oversleep = slept > requested ? slept - requested : 0;
+    // Grow at once, shrink slowly
+    m_oversleep = std::max(oversleep, m_oversleep - m_oversleep / 16);
+  }
+
+  while (SDL_GetPerformanceCounter() < deadline) {
+  }
+}
+
+double Scheduler::getAlpha() const {
+  const Uint64 now = SDL_GetPerformanceCounter();
+  if (now >= m_nextStep) {
+    return 1.0;
+  }
+  return 1.0 - double(m_nextStep - now) / double(m_step);
+}
+
+Uint32 Scheduler::getMsToNextStep() const {
+  const Uint64 now = SDL_GetPerformanceCounter();
+  if (now >= m_nextStep) {
+    return 0;
+  }
+  return Uint32((m_nextStep - now) * 1000 / m_frequency);
+}
+
+double Scheduler::toMs(const Uint64 counts) const {
+  return counts * 1000.0 / m_frequency;
+}
+// SCHEDULER END
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+struct JitterStats {
+  double meanMs = 0.0; // average lateness of a wake up
+  double maxMs = 0.0;  // worst lateness of a wake up
+  Uint64 wakeUps = 0;  // advance() calls with steps due
+  Uint64 steps = 0;    // steps due and run
+  Uint64 dropped = 0;  // steps skipped by the catch-up limit
+};
+
+// Fixed timestep pacing on the performance counter. advance() tells how many
+// steps are due since the last call, and waitForNextStep() sleeps while the
+// next step is far away and spins through the last stretch, where sleeping
+// is too coarse to wake up on time. With maxWaitMs, it returns after about
+// that long when the next step is further away than that.
+class Scheduler {
+public:
+  Scheduler();
+  Scheduler(const double rate, const unsigned int maxCatchUp = 1);
+
+public:
+  void reset();
+  unsigned int advance();
+  void waitForNextStep(const double maxWaitMs = 0.0);
+
+  // Setters
+  void setRate(const double rate);
+  void setMaxCatchUp(const unsigned int maxCatchUp) {
+    m_maxCatchUp = maxCatchUp;
+  }
+
+  // Getters
+  double getAlpha() const;
+  Uint64 getStepTime() const { return m_nextStep - m_step; }
+  Uint64 getStepLength() const { return m_step; }
+  Uint32 getMsToNextStep() const;
+  const JitterStats &getJitter() const { return m_jitter; }
+
+private:
+  double toMs(const Uint64 counts) const;
+
+private:
+  Uint64 m_frequency = 1;
+  Uint64 m_step = 1;
+  Uint64 m_nextStep = 0;
+  unsigned int m_maxCatchUp = 1;
+
+  // Worst recent oversleep, the spinning starts this long before a step
+  Uint64 m_oversleep = 0;
+
+  JitterStats m_jitter;
+  double m_totalLatenessMs = 0.0;
+};
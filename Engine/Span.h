@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+// Non-owning view over a contiguous range
+template <typename T> class Span {
+public:
+  Span() = default;
+  Span(T *data, const std::size_t size) : m_data(data), m_size(size) {}
+
+public:
+  T *begin() const { return m_data; }
+  T *end() const { return m_data + m_size; }
+  T &operator[](const std::size_t index) const { return m_data[index]; }
+
+  // Getters
+  T *data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+private:
+  T *m_data = nullptr;
+  std::size_t m_size = 0;
+};
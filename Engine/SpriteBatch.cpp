@@ -0,0 +1,63 @@
+#include "SpriteBatch.h"
+#include "../Game/Definitions.h"
+
+// SPRITE BATCH START
+void SpriteBatch::clear() {
+  m_vertices.clear();
+  m_runs.clear();
+}
+
+void SpriteBatch::addSprite(const ResidentTexture &texture,
+                            const SDL_Rect &source,
+                            const Rectf &destination) {
+  if (m_runs.empty() || m_runs.back().texture != texture.texture) {
+    m_runs.push_back({texture.texture, size(), 0});
+  }
+  ++m_runs.back().count;
+
+  // Texture coordinates are normalized to the texture size
+  const float u0 = float(source.x) / texture.width;
+  const float v0 = float(source.y) / texture.height;
+  const float u1 = float(source.x + source.w) / texture.width;
+  const float v1 = float(source.y + source.h) / texture.height;
+
+  const float x0 = destination.x * Global::SDL::ScreenWidth;
+  const float y0 = destination.y * Global::SDL::ScreenHeight;
+  const float x1 = x0 + destination.w * Global::SDL::ScreenWidth;
+  const float y1 = y0 + destination.h * Global::SDL::ScreenHeight;
+
+  const SDL_Color white = {255, 255, 255, 255};
+  m_vertices.push_back({{x0, y0}, white, {u0, v0}});
+  m_vertices.push_back({{x1, y0}, white, {u1, v0}});
+  m_vertices.push_back({{x1, y1}, white, {u1, v1}});
+  m_vertices.push_back({{x0, y1}, white, {u0, v1}});
+}
+
+void SpriteBatch::render(SDL_Renderer *renderer) {
+  m_drawCalls = 0;
+  m_textureSwitches = 0;
+  for (const auto &run : m_runs) {
+    if (run.texture != m_boundTexture) {
+      ++m_textureSwitches;
+      m_boundTexture = run.texture;
+    }
+    reserveIndices(run.count);
+    // Indices are relative to the first vertex of the run
+    SDL_RenderGeometry(renderer, run.texture, &m_vertices[run.first * 4],
+                       int(run.count * 4), m_indices.data(),
+                       int(run.count * 6));
+    ++m_drawCalls;
+  }
+  ++m_stats.frames;
+  m_stats.sprites += size();
+  m_stats.drawCalls += m_drawCalls;
+}
+
+void SpriteBatch::reserveIndices(const std::size_t nSprites) {
+  for (std::size_t i = m_indices.size() / 6; i < nSprites; ++i) {
+    const int vertex = i * 4;
+    m_indices.insert(m_indices.end(), {vertex, vertex + 1, vertex + 2,
+                                       vertex, vertex + 2, vertex + 3});
+  }
+}
+// SPRITE BATCH END
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Components_forward.h"
+#include "TextureManager.h"
+#include <SDL2/SDL.h>
+#include <vector>
+
+struct BatchStats {
+  Uint64 frames = 0;    // batches rendered
+  Uint64 sprites = 0;   // sprites over all frames
+  Uint64 drawCalls = 0; // draw calls over all frames
+};
+
+// Collects the quads of a frame into one vertex buffer and submits each run
+// of consecutive sprites sharing a texture with a single SDL_RenderGeometry
+// call. Runs are not reordered across textures, so overlapping sprites keep
+// their drawing order.
+class SpriteBatch {
+public:
+  SpriteBatch() = default;
+
+public:
+  void clear();
+  void addSprite(const ResidentTexture &texture, const SDL_Rect &source,
+                 const Rectf &destination);
+  void render(SDL_Renderer *renderer);
+
+  // Getters
+  std::size_t size() const { return m_vertices.size() / 4; }
+  unsigned int getDrawCalls() const { return m_drawCalls; }
+  unsigned int getTextureSwitches() const { return m_textureSwitches; }
+  const BatchStats &getStats() const { return m_stats; }
+
+private:
+  struct Run {
+    SDL_Texture *texture;
+    std::size_t first; // first sprite of the run
+    std::size_t count;
+  };
+
+  void reserveIndices(const std::size_t nSprites);
+
+private:
+  std::vector<SDL_Vertex> m_vertices;
+  std::vector<int> m_indices; // same two triangles for every sprite
+  std::vector<Run> m_runs;
+  unsigned int m_drawCalls = 0;
+  unsigned int m_textureSwitches = 0; // draw calls binding another texture
+  SDL_Texture *m_boundTexture = nullptr; // of the last draw call
+  BatchStats m_stats;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Lock-free fixed capacity FIFO queue for one producer thread and one
+// consumer thread. Pushing into a full queue fails and leaves it unchanged.
+template <typename T, std::size_t Capacity> class SpscQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "capacity must be a power of two");
+
+public:
+  SpscQueue() = default;
+  SpscQueue(const SpscQueue &) = delete;            // no copy
+  SpscQueue &operator=(const SpscQueue &) = delete; // no copy-assignment
+
+public:
+  // Producer side
+  bool push(const T &value) {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+    m_values[tail & (Capacity - 1)] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side, peek() returns nullptr when the queue is empty
+  const T *peek() const {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &m_values[head & (Capacity - 1)];
+  }
+  void pop() {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+  }
+
+  // Getters
+  static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+  std::array<T, Capacity> m_values;
+  // Indices only ever grow, on their own cache lines so both threads do not
+  // fight over one
+  alignas(64) std::atomic<std::size_t> m_head{0}; // next to pop
+  alignas(64) std::atomic<std::size_t> m_tail{0}; // next to push
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+// 64-bit FNV-1a over the bytes of the simulation state. Floats are hashed
+// bit for bit, so two runs only match when they computed exactly the same.
+class StateHash {
+public:
+  StateHash() = default;
+
+public:
+  void add(const void *data, const std::size_t size) {
+    const Uint8 *bytes = static_cast<const Uint8 *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      m_value = (m_value ^ bytes[i]) * 1099511628211ull;
+    }
+  }
+  template <typename T> void add(const T &value) { add(&value, sizeof(T)); }
+  // The first count elements of the vector
+  template <typename T>
+  void add(const std::vector<T> &values, const std::size_t count) {
+    add(values.data(), count * sizeof(T));
+  }
+
+  // Getters
+  Uint64 getValue() const { return m_value; }
+
+private:
+  Uint64 m_value = 14695981039346656037ull;
+};
@@ -3,8 +3,70 @@
 #include <algorithm>
 #include <iostream>
 
-TextureManager::TextureManager(SDL_Renderer *renderer)
-    : m_SDL_Renderer(renderer) {
+// Transparent gap between packed images, so linear filtering does not bleed
+// neighbours into each other
+static const int AtlasPadding = 1;
+
+// TEXTURE HANDLE START
+TextureHandle::TextureHandle(TextureManager *manager, const Uint32 slot)
+    : m_manager(manager), m_slot(slot) {
+  if (m_manager) {
+    m_manager->addRef(m_slot);
+  }
+}
+
+TextureHandle::TextureHandle(const TextureHandle &other)
+    : TextureHandle(other.m_manager, other.m_slot) {}
+
+TextureHandle &TextureHandle::operator=(const TextureHandle &other) {
+  if (this != &other) {
+    // Acquire first, in case both refer to the same image
+    if (other.m_manager) {
+      other.m_manager->addRef(other.m_slot);
+    }
+    reset();
+    m_manager = other.m_manager;
+    m_slot = other.m_slot;
+  }
+  return *this;
+}
+
+TextureHandle::TextureHandle(TextureHandle &&other) noexcept
+    : m_manager(other.m_manager), m_slot(other.m_slot) {
+  other.m_manager = nullptr;
+  other.m_slot = NoSlot;
+}
+
+TextureHandle &TextureHandle::operator=(TextureHandle &&other) noexcept {
+  if (this != &other) {
+    reset();
+    m_manager = other.m_manager;
+    m_slot = other.m_slot;
+    other.m_manager = nullptr;
+    other.m_slot = NoSlot;
+  }
+  return *this;
+}
+
+void TextureHandle::reset() {
+  if (m_manager) {
+    m_manager->release(m_slot);
+  }
+  m_manager = nullptr;
+  m_slot = NoSlot;
+}
+
+SDL_Rect TextureHandle::getRect() const {
+  if (!m_manager) {
+    return {0, 0, 0, 0};
+  }
+  return m_manager->getRect(m_slot);
+}
+// TEXTURE HANDLE END
+
+// TEXTURE MANAGER START
+TextureManager::TextureManager(SDL_Renderer *renderer, const int atlasSize)
+    : m_SDL_Renderer(renderer), m_atlasSize(atlasSize) {
   if (IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) < 0) {
     std::cout << "Couldn't initialize SDL Image: " << SDL_GetError()
               << std::endl;
@@ -12,19 +74,303 @@ TextureManager::TextureManager(SDL_Renderer *renderer)
 }
 
 TextureManager::~TextureManager() {
-  for (auto &it : m_loadedTextures) {
-    SDL_DestroyTexture(it.second);
-    it.second = nullptr;
+  for (auto &texture : m_textures) {
+    SDL_DestroyTexture(texture.resident.texture);
+    texture.resident.texture = nullptr;
   }
 }
 
-SDL_Texture *TextureManager::GetTexture(const std::string &filePath) {
-  auto it = m_loadedTextures.find(filePath);
-  if (it == m_loadedTextures.end()) {
-    SDL_Texture *texture = IMG_LoadTexture(m_SDL_Renderer, filePath.c_str());
-    m_loadedTextures.emplace(std::make_pair(filePath, texture));
-    return texture;
-  } else {
+TextureHandle TextureManager::Load(const std::string &filePath) {
+  TextureHandle handle = Acquire(TextureId(filePath));
+  if (handle.isValid()) {
+    return handle;
+  }
+  const Uint32 slot = addImage(filePath, NoPackImage, decodeImage(filePath));
+  if (slot == TextureHandle::NoSlot) {
+    return TextureHandle();
+  }
+  return TextureHandle(this, slot);
+}
+
+TextureHandle TextureManager::Acquire(const TextureId id) {
+  auto it = m_ids.find(id.getValue());
+  if (it == m_ids.end()) {
+    return TextureHandle();
+  }
+  return TextureHandle(this, it->second);
+}
+
+void TextureManager::Preload(const std::vector<std::string> &filePaths,
+                             JobSystem *jobs) {
+  std::vector<std::string> pending;
+  for (const auto &filePath : filePaths) {
+    if (m_ids.find(TextureId(filePath).getValue()) == m_ids.end() &&
+        std::find(pending.begin(), pending.end(), filePath) ==
+            pending.end()) {
+      pending.push_back(filePath);
+    }
+  }
+
+  // Decoding only touches the surfaces, uploads need the renderer thread
+  std::vector<SDL_Surface *> images(pending.size(), nullptr);
+  parallelFor(jobs, pending.size(), 1,
+              [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                  images[i] = decodeImage(pending[i]);
+                }
+              });
+
+  // Uploaded in manifest order, so the atlas layout does not depend on
+  // which decode finished first
+  for (std::size_t i = 0; i < pending.size(); ++i) {
+    addImage(pending[i], NoPackImage, images[i]);
+  }
+}
+
+void TextureManager::LoadPack(std::unique_ptr<AssetPack> pack) {
+  if (m_pack) {
+    std::cout << "An asset pack is already loaded" << std::endl;
+    return;
+  }
+  m_pack = std::move(pack);
+  for (Uint32 i = 0; i < m_pack->getImageCount(); ++i) {
+    const PackImage &image = m_pack->getImage(i);
+    if (m_ids.find(TextureId(image.name).getValue()) == m_ids.end()) {
+      Image source;
+      source.packImage = i;
+      addImage(image.name, i, loadPixels(source));
+    }
+  }
+}
+
+void TextureManager::BeginFrame() {
+  // Whatever the last frame did not draw may go
+  makeRoom(0);
+  ++m_frame;
+}
+
+const ResidentTexture *TextureManager::Resolve(const Uint32 slot) {
+  if (slot >= m_images.size() || !m_images[slot].alive) {
+    return nullptr;
+  }
+  const Uint32 index = m_images[slot].texture;
+  if (!m_textures[index].resident.texture && !upload(index)) {
+    return nullptr;
+  }
+  m_textures[index].lastUsed = m_frame;
+  return &m_textures[index].resident;
+}
+
+SDL_Surface *TextureManager::decodeImage(const std::string &filePath) {
+  SDL_Surface *loaded = IMG_Load(filePath.c_str());
+  if (!loaded) {
+    std::cout << "Couldn't load " << filePath << ": " << SDL_GetError()
+              << std::endl;
+    return nullptr;
+  }
+  SDL_Surface *image =
+      SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(loaded);
+  if (!image) {
+    std::cout << "Couldn't convert " << filePath << ": " << SDL_GetError()
+              << std::endl;
+  }
+  return image;
+}
+
+SDL_Surface *TextureManager::loadPixels(const Image &image) const {
+  if (image.packImage == NoPackImage) {
+    return decodeImage(image.filePath);
+  }
+  // Wraps the mapped pixels, uploads read them in place
+  const PackImage &packed = m_pack->getImage(image.packImage);
+  return SDL_CreateRGBSurfaceWithFormatFrom(
+      const_cast<void *>(m_pack->getPixels(image.packImage)), packed.width,
+      packed.height, 32, packed.pitch, SDL_PIXELFORMAT_RGBA32);
+}
+
+Uint32 TextureManager::addImage(const std::string &filePath,
+                                const Uint32 packIndex, SDL_Surface *pixels) {
+  if (!pixels) {
+    return TextureHandle::NoSlot;
+  }
+  const TextureId id(filePath);
+  auto it = m_ids.find(id.getValue());
+  if (it != m_ids.end()) {
+    if (m_images[it->second].filePath != filePath) {
+      std::cout << "Texture id of " << filePath << " collides with "
+                << m_images[it->second].filePath << std::endl;
+    }
+    SDL_FreeSurface(pixels);
     return it->second;
   }
-}
\ No newline at end of file
+
+  Uint32 slot;
+  if (m_freeImages.empty()) {
+    slot = m_images.size();
+    m_images.emplace_back();
+  } else {
+    slot = m_freeImages.back();
+    m_freeImages.pop_back();
+  }
+  Image &image = m_images[slot];
+  image.id = id;
+  image.filePath = filePath;
+  image.packImage = packIndex;
+  image.rect = {0, 0, pixels->w, pixels->h};
+  image.refCount = 0;
+  image.alive = true;
+  m_ids[id.getValue()] = slot;
+
+  if (m_atlasSize <= 0 || !packIntoAtlas(slot, pixels)) {
+    // Not packing, or too big for a page: the image keeps its own texture
+    image.texture = createTexture(false, pixels->w, pixels->h);
+    Texture &texture = m_textures[image.texture];
+    if (upload(image.texture)) {
+      SDL_UpdateTexture(texture.resident.texture, nullptr, pixels->pixels,
+                        pixels->pitch);
+    }
+    texture.images.push_back(slot);
+  }
+  SDL_FreeSurface(pixels);
+  return slot;
+}
+
+bool TextureManager::packIntoAtlas(const Uint32 slot,
+                                   SDL_Surface *pixels) {
+  const int w = pixels->w + AtlasPadding;
+  const int h = pixels->h + AtlasPadding;
+  if (w > m_atlasSize || h > m_atlasSize) {
+    return false;
+  }
+
+  // First page with room for it, or a new one
+  SDL_Rect rect;
+  Uint32 page = m_textures.size();
+  for (Uint32 i = 0; i < m_textures.size(); ++i) {
+    Texture &texture = m_textures[i];
+    if (texture.alive && texture.atlas && texture.packer.insert(w, h, rect)) {
+      page = i;
+      break;
+    }
+  }
+  if (page == m_textures.size()) {
+    page = createTexture(true, m_atlasSize, m_atlasSize);
+    if (!m_textures[page].packer.insert(w, h, rect)) {
+      return false;
+    }
+    upload(page);
+  }
+
+  Image &image = m_images[slot];
+  image.texture = page;
+  image.rect = {rect.x, rect.y, pixels->w, pixels->h};
+  m_textures[page].images.push_back(slot);
+  // An evicted page gets the image with the rest when it is reloaded
+  if (m_textures[page].resident.texture) {
+    SDL_UpdateTexture(m_textures[page].resident.texture, &image.rect,
+                      pixels->pixels, pixels->pitch);
+  }
+  return true;
+}
+
+Uint32 TextureManager::createTexture(const bool atlas, const int width,
+                                     const int height) {
+  Uint32 index;
+  if (m_freeTextures.empty()) {
+    index = m_textures.size();
+    m_textures.emplace_back();
+  } else {
+    index = m_freeTextures.back();
+    m_freeTextures.pop_back();
+  }
+  Texture &texture = m_textures[index];
+  texture.resident = {nullptr, width, height};
+  texture.atlas = atlas;
+  texture.packer = SkylinePacker(atlas ? width : 0, atlas ? height : 0);
+  texture.images.clear();
+  texture.lastUsed = m_frame;
+  texture.alive = true;
+  return index;
+}
+
+bool TextureManager::upload(const Uint32 index) {
+  const std::size_t bytes = getBytes(m_textures[index]);
+  makeRoom(bytes);
+
+  Texture &texture = m_textures[index];
+  texture.resident.texture = SDL_CreateTexture(
+      m_SDL_Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+      texture.resident.width, texture.resident.height);
+  if (!texture.resident.texture) {
+    std::cout << "Couldn't create texture: " << SDL_GetError() << std::endl;
+    return false;
+  }
+  SDL_SetTextureBlendMode(texture.resident.texture, SDL_BLENDMODE_BLEND);
+  m_residentBytes += bytes;
+
+  if (texture.atlas) {
+    // Static textures start with undefined content, clear the padding
+    std::vector<Uint8> blank(bytes, 0);
+    SDL_UpdateTexture(texture.resident.texture, nullptr, blank.data(),
+                      texture.resident.width * 4);
+  }
+  for (const auto slot : texture.images) {
+    SDL_Surface *pixels = loadPixels(m_images[slot]);
+    if (pixels) {
+      SDL_UpdateTexture(texture.resident.texture, &m_images[slot].rect,
+                        pixels->pixels, pixels->pitch);
+      SDL_FreeSurface(pixels);
+    }
+  }
+  return true;
+}
+
+void TextureManager::evict(Texture &texture) {
+  SDL_DestroyTexture(texture.resident.texture);
+  texture.resident.texture = nullptr;
+  m_residentBytes -= getBytes(texture);
+}
+
+void TextureManager::makeRoom(const std::size_t bytes) {
+  while (m_residentBytes + bytes > m_budget) {
+    // Least recently drawn texture not drawn in the current frame
+    Texture *oldest = nullptr;
+    for (auto &texture : m_textures) {
+      if (texture.alive && texture.resident.texture &&
+          texture.lastUsed < m_frame &&
+          (!oldest || texture.lastUsed < oldest->lastUsed)) {
+        oldest = &texture;
+      }
+    }
+    if (!oldest) {
+      return;
+    }
+    evict(*oldest);
+    ++m_evictions;
+  }
+}
+
+void TextureManager::release(const Uint32 slot) {
+  Image &image = m_images[slot];
+  if (--image.refCount > 0) {
+    return;
+  }
+
+  // Unregister the image, and its texture once no other image uses it
+  Texture &texture = m_textures[image.texture];
+  texture.images.erase(
+      std::find(texture.images.begin(), texture.images.end(), slot));
+  if (texture.images.empty()) {
+    if (texture.resident.texture) {
+      evict(texture);
+    }
+    texture.alive = false;
+    m_freeTextures.push_back(image.texture);
+  }
+  m_ids.erase(image.id.getValue());
+  image.filePath.clear();
+  image.alive = false;
+  m_freeImages.push_back(slot);
+}
+// TEXTURE MANAGER END
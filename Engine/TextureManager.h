@@ -1,12 +1,66 @@
 #pragma once
 
+#include "AssetPack.h"
+#include "AtlasPacker.h"
+#include "JobSystem.h"
+#include "ResourceId.h"
 #include <SDL2/SDL.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+class TextureManager;
+
+// A texture as it can be drawn right now
+struct ResidentTexture {
+  SDL_Texture *texture;
+  int width;
+  int height;
+};
+
+// Counted reference to a loaded image. The image stays registered while
+// handles to it exist, handles must not outlive their manager.
+class TextureHandle {
+public:
+  static const Uint32 NoSlot = 0xFFFFFFFFu;
+
+  TextureHandle() = default;
+  TextureHandle(TextureManager *manager, const Uint32 slot);
+  TextureHandle(const TextureHandle &other);
+  TextureHandle &operator=(const TextureHandle &other);
+  TextureHandle(TextureHandle &&other) noexcept;
+  TextureHandle &operator=(TextureHandle &&other) noexcept;
+  ~TextureHandle() { reset(); }
+
+public:
+  void reset();
+
+  // Getters
+  bool isValid() const { return m_manager != nullptr; }
+  Uint32 getSlot() const { return m_slot; }
+  SDL_Rect getRect() const; // where the image lies in its texture
+
+private:
+  TextureManager *m_manager = nullptr;
+  Uint32 m_slot = NoSlot;
+};
+
+// Images are registered under the id of their path and handed out as
+// handles to their slot, so drawing never hashes anything.
+// With an atlas size, images are packed into shared atlas pages of that
+// size, so sprites from different images can be drawn without switching
+// textures. Images too big for a page keep their own texture.
+// Preload() decodes a list of images in parallel on the job system and then
+// uploads them on the calling thread, which must own the renderer.
+// LoadPack() uploads the pre-decoded images of an asset pack, named after
+// the paths they were baked from, and keeps the pack mapped for reloads.
+// Textures not drawn in the last frame are evicted, least recently drawn
+// first, while the resident ones exceed the budget. Resolve() reloads them
+// on demand.
 class TextureManager {
 public:
-  TextureManager(SDL_Renderer *renderer);
+  TextureManager(SDL_Renderer *renderer, const int atlasSize = 0);
   ~TextureManager();
   TextureManager(const TextureManager &) = delete; // no copy
   TextureManager &
@@ -15,9 +69,75 @@ public:
   TextureManager &operator=(TextureManager &&) = delete; // no move-assignment
 
 public:
-  SDL_Texture *GetTexture(const std::string &filePath);
+  TextureHandle Load(const std::string &filePath);
+  TextureHandle Acquire(const TextureId id); // invalid if never loaded
+  void Preload(const std::vector<std::string> &filePaths,
+               JobSystem *jobs = nullptr);
+  void LoadPack(std::unique_ptr<AssetPack> pack);
+
+  // Render thread only
+  void BeginFrame();
+  const ResidentTexture *Resolve(const Uint32 slot);
+
+  // Setters
+  void setBudget(const std::size_t bytes) { m_budget = bytes; }
+
+  // Getters
+  SDL_Rect getRect(const Uint32 slot) const { return m_images[slot].rect; }
+  std::size_t getResidentBytes() const { return m_residentBytes; }
+  Uint64 getEvictionCount() const { return m_evictions; }
+
+private:
+  friend class TextureHandle;
+
+  static const Uint32 NoPackImage = 0xFFFFFFFFu;
+
+  struct Image {
+    TextureId id;
+    std::string filePath;
+    Uint32 packImage = NoPackImage; // where to reload it from, if packed
+    Uint32 texture = 0;
+    SDL_Rect rect = {0, 0, 0, 0};
+    Uint32 refCount = 0;
+    bool alive = false;
+  };
+
+  // Unit of residency, an atlas page or an image on its own
+  struct Texture {
+    ResidentTexture resident = {nullptr, 0, 0};
+    bool atlas = false;
+    SkylinePacker packer{0, 0};
+    std::vector<Uint32> images;
+    Uint64 lastUsed = 0;
+    bool alive = false;
+  };
+
+  static SDL_Surface *decodeImage(const std::string &filePath);
+  SDL_Surface *loadPixels(const Image &image) const;
+  Uint32 addImage(const std::string &filePath, const Uint32 packIndex,
+                  SDL_Surface *pixels);
+  bool packIntoAtlas(const Uint32 slot, SDL_Surface *pixels);
+  Uint32 createTexture(const bool atlas, const int width, const int height);
+  bool upload(const Uint32 index);
+  void evict(Texture &texture);
+  void makeRoom(const std::size_t bytes);
+  void addRef(const Uint32 slot) { ++m_images[slot].refCount; }
+  void release(const Uint32 slot);
+  static std::size_t getBytes(const Texture &texture) {
+    return std::size_t(texture.resident.width) * texture.resident.height * 4;
+  }
 
 private:
-  std::unordered_map<std::string, SDL_Texture *> m_loadedTextures;
+  std::vector<Image> m_images;
+  std::vector<Uint32> m_freeImages;
+  std::vector<Texture> m_textures;
+  std::vector<Uint32> m_freeTextures;
+  std::unordered_map<Uint32, Uint32> m_ids; // id to image slot
+  std::unique_ptr<AssetPack> m_pack;
   SDL_Renderer *m_SDL_Renderer;
+  int m_atlasSize; // 0 when not packing
+  std::size_t m_budget = ~std::size_t(0);
+  std::size_t m_residentBytes = 0;
+  Uint64 m_frame = 0;
+  Uint64 m_evictions = 0;
 };
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+
+// Lock-free single producer, single consumer triple buffer. The producer
+// always has a buffer to write to, the consumer always has the latest
+// complete one to read from, and neither ever waits for the other.
+template <typename T> class TripleBuffer {
+public:
+  TripleBuffer() = default;
+  TripleBuffer(const TripleBuffer &) = delete;            // no copy
+  TripleBuffer &operator=(const TripleBuffer &) = delete; // no copy-assignment
+
+public:
+  // Producer side
+  T &getWriteBuffer() { return m_buffers[m_write]; }
+  void publish() {
+    m_write = m_ready.exchange(m_write | FreshBit, std::memory_order_acq_rel) &
+              IndexMask;
+  }
+
+  // Consumer side, returns true if a newer buffer was published
+  bool fetch() {
+    if (!(m_ready.load(std::memory_order_relaxed) & FreshBit)) {
+      return false;
+    }
+    m_read = m_ready.exchange(m_read, std::memory_order_acq_rel) & IndexMask;
+    return true;
+  }
+  const T &getReadBuffer() const { return m_buffers[m_read]; }
+
+private:
+  static const unsigned int IndexMask = 3;
+  static const unsigned int FreshBit = 4;
+
+  T m_buffers[3];
+  unsigned int m_write = 0;
+  unsigned int m_read = 1;
+  std::atomic<unsigned int> m_ready{2};
+};
@@ -0,0 +1,346 @@
+#include "World.h"
+#include "../Game/Definitions.h"
+
+// WORLD START
+Entity World::createEntity(const ComponentMask components) {
+  Uint32 index;
+  if (m_freeIndices.empty()) {
+    index = m_records.size();
+    m_records.emplace_back();
+  } else {
+    index = m_freeIndices.back();
+    m_freeIndices.pop_back();
+  }
+
+  const Uint32 archetypeIndex = findArchetype(components);
+  Archetype &archetype = m_archetypes[archetypeIndex];
+  EntityRecord &record = m_records[index];
+  const Entity entity = {index, record.generation};
+  record.archetype = archetypeIndex;
+  record.row = archetype.entities.size();
+  record.alive = true;
+
+  archetype.entities.push_back(entity);
+  if (components & TransformComponent) {
+    archetype.transforms.push_back({0.0f, 0.0f, 0.0f, 0.0f});
+    archetype.previousTransforms.push_back({0.0f, 0.0f, 0.0f, 0.0f});
+#ifdef FIXED_POINT_PHYSICS
+    archetype.fixedTransforms.push_back({0, 0, 0, 0});
+#endif
+  }
+  if (components & VelocityComponent) {
+    archetype.velocities.push_back({0.0f, 0.0f});
+#ifdef FIXED_POINT_PHYSICS
+    archetype.fixedVelocities.push_back({0, 0});
+#endif
+  }
+  if (components & AnimationComponent) {
+    archetype.animations.emplace_back();
+  }
+  if (components & LifespanComponent) {
+    archetype.lifespans.push_back(0);
+  }
+  if (components & HealthComponent) {
+    archetype.healths.push_back(0);
+  }
+  ++m_nAlive;
+  return entity;
+}
+
+void World::destroyEntity(const Entity entity) {
+  if (!isAlive(entity)) {
+    return;
+  }
+  EntityRecord &record = m_records[entity.index];
+  removeRow(m_archetypes[record.archetype], record.row);
+  record.alive = false;
+  ++record.generation;
+  m_freeIndices.push_back(entity.index);
+  --m_nAlive;
+}
+
+bool World::isAlive(const Entity entity) const {
+  return entity.index < m_records.size() &&
+         m_records[entity.index].alive &&
+         m_records[entity.index].generation == entity.generation;
+}
+
+bool World::hasComponents(const Entity entity,
+                          const ComponentMask mask) const {
+  if (!isAlive(entity)) {
+    return false;
+  }
+  const Archetype &archetype =
+      m_archetypes[m_records[entity.index].archetype];
+  return (archetype.mask & mask) == mask;
+}
+
+Entity World::getEntity(const Uint32 index) const {
+  return {index, m_records[index].generation};
+}
+
+void World::setTransform(const Entity entity, const Rectf &transform) {
+  const EntityRecord &record = m_records[entity.index];
+  Archetype &archetype = m_archetypes[record.archetype];
+#ifdef FIXED_POINT_PHYSICS
+  // Rounded to the fixed-point transform
+  archetype.fixedTransforms[record.row] = toFixedRect(transform);
+  archetype.transforms[record.row] =
+      toNormalizedRect(archetype.fixedTransforms[record.row]);
+#else
+  archetype.transforms[record.row] = transform;
+#endif
+  archetype.previousTransforms[record.row] = archetype.transforms[record.row];
+}
+
+const Rectf &World::getTransform(const Entity entity) const {
+  const EntityRecord &record = m_records[entity.index];
+  return m_archetypes[record.archetype].transforms[record.row];
+}
+
+void World::setVelocity(const Entity entity, const Velocity &velocity) {
+  const EntityRecord &record = m_records[entity.index];
+  Archetype &archetype = m_archetypes[record.archetype];
+#ifdef FIXED_POINT_PHYSICS
+  FixedVelocity &fixed = archetype.fixedVelocities[record.row];
+  fixed = {toFixedX(velocity.vx), toFixedY(velocity.vy)};
+  archetype.velocities[record.row] = {toNormalizedX(fixed.vx),
+                                      toNormalizedY(fixed.vy)};
+#else
+  archetype.velocities[record.row] = velocity;
+#endif
+}
+
+const Velocity &World::getVelocity(const Entity entity) const {
+  const EntityRecord &record = m_records[entity.index];
+  return m_archetypes[record.archetype].velocities[record.row];
+}
+
+Animation &World::getAnimation(const Entity entity) {
+  const EntityRecord &record = m_records[entity.index];
+  return m_archetypes[record.archetype].animations[record.row];
+}
+
+void World::startAnimation(const Entity entity, const AnimationClip &clip) {
+  getAnimation(entity).setClip(clip, m_time);
+}
+
+Uint32 &World::getLifespan(const Entity entity) {
+  const EntityRecord &record = m_records[entity.index];
+  return m_archetypes[record.archetype].lifespans[record.row];
+}
+
+int &World::getHealth(const Entity entity) {
+  const EntityRecord &record = m_records[entity.index];
+  return m_archetypes[record.archetype].healths[record.row];
+}
+
+void World::integrate(const Uint32 &dt, JobSystem *jobs) {
+  const ComponentMask required = TransformComponent | VelocityComponent;
+  for (auto &archetype : m_archetypes) {
+    if ((archetype.mask & required) != required) {
+      continue;
+    }
+    const bool gravitySensitive = archetype.mask & GravityComponent;
+#ifdef FIXED_POINT_PHYSICS
+    const Fixed step = toFixed(float(dt));
+    const Fixed floor = getFixedFloor();
+    const Fixed gravity = fixedMul(getFixedGravity(), step);
+    parallelFor(
+        jobs, archetype.entities.size(), Global::Jobs::ChunkSize,
+        [&](const std::size_t begin, const std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i) {
+            FixedRect &dst = archetype.fixedTransforms[i];
+            FixedVelocity &velocity = archetype.fixedVelocities[i];
+            archetype.previousTransforms[i] = archetype.transforms[i];
+            dst.x += fixedMul(velocity.vx, step);
+            dst.y += fixedMul(velocity.vy, step);
+            if (dst.y + dst.h >= floor) {
+              dst.y = floor - dst.h;
+              velocity.vy = 0;
+            } else if (gravitySensitive) {
+              velocity.vy += gravity;
+            }
+            archetype.transforms[i] = toNormalizedRect(dst);
+            archetype.velocities[i].vy = toNormalizedY(velocity.vy);
+          }
+        });
+#else
+    parallelFor(
+        jobs, archetype.entities.size(), Global::Jobs::ChunkSize,
+        [&](const std::size_t begin, const std::size_t end) {
+          for (std::size_t i = begin; i < end; ++i) {
+            Rectf &dst = archetype.transforms[i];
+            Velocity &velocity = archetype.velocities[i];
+            archetype.previousTransforms[i] = dst;
+            dst.x += velocity.vx * dt;
+            dst.y += velocity.vy * dt;
+            if (dst.y + dst.h >= Global::Game::Floor) {
+              dst.y = Global::Game::Floor - dst.h;
+              velocity.vy = 0.0f;
+            } else if (gravitySensitive) {
+              velocity.vy += Global::Game::Gravity * dt;
+            }
+          }
+        });
+#endif
+  }
+}
+
+void World::updateLifespans(const Uint32 &dt) {
+  for (auto &archetype : m_archetypes) {
+    if (!(archetype.mask & LifespanComponent)) {
+      continue;
+    }
+    // Backwards, so the row swapped in by a removal was already visited
+    for (std::size_t i = archetype.entities.size(); i-- > 0;) {
+      if (archetype.lifespans[i] <= dt) {
+        destroyEntity(archetype.entities[i]);
+      } else {
+        archetype.lifespans[i] -= dt;
+      }
+    }
+  }
+}
+
+void World::applyDamage(const Entity entity, const int damage) {
+  if (hasComponents(entity, HealthComponent)) {
+    getHealth(entity) -= damage;
+  }
+}
+
+void World::removeDefeated() {
+  for (auto &archetype : m_archetypes) {
+    if (!(archetype.mask & HealthComponent)) {
+      continue;
+    }
+    for (std::size_t i = archetype.entities.size(); i-- > 0;) {
+      if (archetype.healths[i] <= 0) {
+        destroyEntity(archetype.entities[i]);
+      }
+    }
+  }
+}
+
+void World::addColliders(SpatialHashGrid &grid, const Uint32 layer,
+                         const Uint32 mask) const {
+  for (const auto &archetype : m_archetypes) {
+    if (!(archetype.mask & TransformComponent)) {
+      continue;
+    }
+    for (std::size_t i = 0; i < archetype.entities.size(); ++i) {
+      grid.addCollider(archetype.previousTransforms[i],
+                       archetype.transforms[i], layer, mask,
+                       archetype.entities[i].index);
+    }
+  }
+}
+
+void World::render(RenderSnapshot &snapshot) {
+  const ComponentMask required = TransformComponent | AnimationComponent;
+  for (auto &archetype : m_archetypes) {
+    if ((archetype.mask & required) != required) {
+      continue;
+    }
+    for (std::size_t i = 0; i < archetype.entities.size(); ++i) {
+      archetype.animations[i].render(snapshot,
+                                     archetype.previousTransforms[i],
+                                     archetype.transforms[i], m_time);
+    }
+  }
+}
+
+void World::hashState(StateHash &hash) const {
+  for (const auto &archetype : m_archetypes) {
+    const std::size_t rows = archetype.entities.size();
+    hash.add(archetype.mask);
+    hash.add(rows);
+    hash.add(archetype.entities, rows);
+#ifdef FIXED_POINT_PHYSICS
+    if (archetype.mask & TransformComponent) {
+      hash.add(archetype.fixedTransforms, rows);
+    }
+    if (archetype.mask & VelocityComponent) {
+      hash.add(archetype.fixedVelocities, rows);
+    }
+#else
+    if (archetype.mask & TransformComponent) {
+      hash.add(archetype.transforms, rows);
+    }
+    if (archetype.mask & VelocityComponent) {
+      hash.add(archetype.velocities, rows);
+    }
+#endif
+    if (archetype.mask & LifespanComponent) {
+      hash.add(archetype.lifespans, rows);
+    }
+    if (archetype.mask & HealthComponent) {
+      hash.add(archetype.healths, rows);
+    }
+  }
+}
+
+Uint32 World::findArchetype(const ComponentMask mask) {
+  for (Uint32 i = 0; i < m_archetypes.size(); ++i) {
+    if (m_archetypes[i].mask == mask) {
+      return i;
+    }
+  }
+  m_archetypes.emplace_back();
+  m_archetypes.back().mask = mask;
+  return m_archetypes.size() - 1;
+}
+
+void World::removeRow(Archetype &archetype, const Uint32 row) {
+  const Uint32 last = archetype.entities.size() - 1;
+  if (row != last) {
+    archetype.entities[row] = archetype.entities[last];
+    m_records[archetype.entities[row].index].row = row;
+    if (archetype.mask & TransformComponent) {
+      archetype.transforms[row] = archetype.transforms[last];
+      archetype.previousTransforms[row] = archetype.previousTransforms[last];
+#ifdef FIXED_POINT_PHYSICS
+      archetype.fixedTransforms[row] = archetype.fixedTransforms[last];
+#endif
+    }
+    if (archetype.mask & VelocityComponent) {
+      archetype.velocities[row] = archetype.velocities[last];
+#ifdef FIXED_POINT_PHYSICS
+      archetype.fixedVelocities[row] = archetype.fixedVelocities[last];
+#endif
+    }
+    if (archetype.mask & AnimationComponent) {
+      archetype.animations[row] = archetype.animations[last];
+    }
+    if (archetype.mask & LifespanComponent) {
+      archetype.lifespans[row] = archetype.lifespans[last];
+    }
+    if (archetype.mask & HealthComponent) {
+      archetype.healths[row] = archetype.healths[last];
+    }
+  }
+  archetype.entities.pop_back();
+  if (archetype.mask & TransformComponent) {
+    archetype.transforms.pop_back();
+    archetype.previousTransforms.pop_back();
+#ifdef FIXED_POINT_PHYSICS
+    archetype.fixedTransforms.pop_back();
+#endif
+  }
+  if (archetype.mask & VelocityComponent) {
+    archetype.velocities.pop_back();
+#ifdef FIXED_POINT_PHYSICS
+    archetype.fixedVelocities.pop_back();
+#endif
+  }
+  if (archetype.mask & AnimationComponent) {
+    archetype.animations.pop_back();
+  }
+  if (archetype.mask & LifespanComponent) {
+    archetype.lifespans.pop_back();
+  }
+  if (archetype.mask & HealthComponent) {
+    archetype.healths.pop_back();
+  }
+}
+// WORLD END
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Collision.h"
+#include "Components.h"
+#include "Components_forward.h"
+#include "FixedPoint.h"
+#include "JobSystem.h"
+#include "StateHash.h"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Component flags, combined in an entity's component mask
+enum ComponentFlag : Uint32 {
+  TransformComponent = 1 << 0,
+  VelocityComponent = 1 << 1,
+  GravityComponent = 1 << 2, // tag only, no data
+  AnimationComponent = 1 << 3,
+  LifespanComponent = 1 << 4,
+  HealthComponent = 1 << 5
+};
+
+using ComponentMask = Uint32;
+
+struct Velocity {
+  float vx, vy;
+};
+
+// Entities are plain ids. The generation tells apart an entity from a newer
+// one reusing the same index after the first was destroyed.
+struct Entity {
+  Uint32 index;
+  Uint32 generation;
+};
+
+// Every entity with the same component mask lives in the same archetype,
+// one row per entity, with each component packed in its own array.
+// Arrays of components not in the mask stay empty.
+struct Archetype {
+  ComponentMask mask = 0;
+  std::vector<Entity> entities;
+  std::vector<Rectf> transforms;
+  std::vector<Rectf> previousTransforms; // before the last integration
+  std::vector<Velocity> velocities;
+#ifdef FIXED_POINT_PHYSICS
+  // The physics run on these, transforms and velocities follow them
+  std::vector<FixedRect> fixedTransforms;
+  std::vector<FixedVelocity> fixedVelocities;
+#endif
+  std::vector<Animation> animations;
+  std::vector<Uint32> lifespans;
+  std::vector<int> healths;
+};
+
+class World {
+public:
+  World() = default;
+
+public:
+  // Entities
+  Entity createEntity(const ComponentMask components);
+  void destroyEntity(const Entity entity);
+  bool isAlive(const Entity entity) const;
+  bool hasComponents(const Entity entity, const ComponentMask mask) const;
+  Entity getEntity(const Uint32 index) const;
+  std::size_t size() const { return m_nAlive; }
+
+  // Components
+  void setTransform(const Entity entity, const Rectf &transform);
+  const Rectf &getTransform(const Entity entity) const;
+  void setVelocity(const Entity entity, const Velocity &velocity);
+  const Velocity &getVelocity(const Entity entity) const;
+  Animation &getAnimation(const Entity entity);
+  // Plays the clip from the current world time
+  void startAnimation(const Entity entity, const AnimationClip &clip);
+  Uint32 &getLifespan(const Entity entity);
+  int &getHealth(const Entity entity);
+
+  // Systems
+  void integrate(const Uint32 &dt, JobSystem *jobs = nullptr);
+  void advanceTime(const Uint32 &dt) { m_time += dt; }
+  void updateLifespans(const Uint32 &dt);
+  void applyDamage(const Entity entity, const int damage);
+  void removeDefeated();
+  void addColliders(SpatialHashGrid &grid, const Uint32 layer,
+                    const Uint32 mask) const;
+  void render(RenderSnapshot &snapshot);
+  void hashState(StateHash &hash) const;
+
+  // Getters
+  Uint32 getTime() const { return m_time; }
+
+private:
+  struct EntityRecord {
+    Uint32 generation = 0;
+    Uint32 archetype = 0;
+    Uint32 row = 0;
+    bool alive = false;
+  };
+
+  Uint32 findArchetype(const ComponentMask mask);
+  void removeRow(Archetype &archetype, const Uint32 row);
+
+private:
+  std::vector<Archetype> m_archetypes;
+  std::vector<EntityRecord> m_records;
+  std::vector<Uint32> m_freeIndices;
+  std::size_t m_nAlive = 0;
+  Uint32 m_time = 0; // ms simulated, animations play on it
+};
@@ -0,0 +1,66 @@
+#include "Definitions.h"
+#include "Game.h"
+
+BenchmarkStats Game::RunBenchmark(const unsigned int ticks,
+                                  const unsigned int bullets) {
+  BenchmarkStats stats;
+  if (!m_isInitialized) {
+    return stats;
+  }
+
+  // Input script, one entry per period: fire all along, run right then left
+  // and jump in between
+  struct ScriptedEvent {
+    unsigned int tick;
+    KbdEvents event;
+  };
+  const unsigned int period = 4 * Global::Game::ModelRate;
+  const ScriptedEvent script[] = {
+      {0, KbdEvents::LCtrl_KeyDown},
+      {1, KbdEvents::Right_KeyDown},
+      {period / 4, KbdEvents::Right_KeyUp},
+      {period / 4 + 1, KbdEvents::Space_KeyDown},
+      {period / 4 + 2, KbdEvents::Space_KeyUp},
+      {period / 2, KbdEvents::Left_KeyDown},
+      {3 * period / 4, KbdEvents::Left_KeyUp},
+  };
+
+  // Simulated time, the model never waits for the clock
+  const Uint64 step = m_modelScheduler.getStepLength();
+  Uint64 tickEnd = SDL_GetPerformanceCounter();
+  Uint32 seed = 12345;
+  const auto random = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return float(seed >> 8) / float(1u << 24);
+  };
+
+  double entities = 0.0;
+  const Uint64 start = SDL_GetPerformanceCounter();
+  for (unsigned int tick = 0; tick < ticks; ++tick) {
+    tickEnd += step;
+    for (const auto &scripted : script) {
+      if (tick % period == scripted.tick) {
+        m_pendingEvents.push({scripted.event, tickEnd - step / 2});
+      }
+    }
+    while (m_playerBullets.size() < bullets &&
+           m_playerBullets.spawn(random(), random(),
+                                 (random() - 0.5f) * 0.0004f,
+                                 (random() - 0.5f) * 0.0004f)) {
+    }
+
+    updateModel(tickEnd);
+    publishSnapshot();
+    entities += 1 + m_world.size() + m_playerBullets.size();
+  }
+  const Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+  stats.ticks = ticks;
+  stats.seconds = double(elapsed) / SDL_GetPerformanceFrequency();
+  if (ticks > 0 && stats.seconds > 0.0) {
+    stats.ticksPerSecond = ticks / stats.seconds;
+    stats.meanEntities = entities / ticks;
+    stats.nsPerEntity = stats.seconds * 1e9 / entities;
+  }
+  return stats;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../Engine/ResourceId.h"
+#include <cstddef>
 #include <string>
 
 namespace Global {
@@ -7,21 +9,58 @@ namespace Global {
 namespace Game {
 const std::string Name = "MyGame";
 const int FrameRate = 60;  // frames per second
-const int ModelRate = 200; // updates per second
+const int ModelRate = 50;  // updates per second
+const int MaxCatchUp = 5;  // model updates run at most per wake up
 const float Floor = 1.0f;  // position of floor
-const float Gravity = 0.0001f;
+const float Gravity = 0.00002f; // vertical speed gained per ms
+const unsigned int MaxProjectiles = 32768; // live bullets per pool
+const float CollisionCellSize = 0.1f;      // broad-phase grid cell
+const std::size_t TickArenaSize = 1u << 20; // bytes, grows if exceeded
+static_assert(1000 % ModelRate == 0, "model updates must last whole ms");
 } // namespace Game
 
+namespace Jobs {
+const unsigned int ChunkSize = 4096;        // entities per job
+const unsigned int CollisionChunkSize = 64; // grid cells per job
+} // namespace Jobs
+
+namespace Input {
+const std::size_t BufferCapacity = 256; // events queued between updates
+} // namespace Input
+
+namespace Metrics {
+const double LogInterval = 5.0; // seconds between percentile log lines
+const float OverlayScale = 2.0f / Game::FrameRate; // seconds in the overlay
+} // namespace Metrics
+
+namespace Trace {
+const std::string FilePath = "./trace.json"; // profiler builds only
+} // namespace Trace
+
 namespace SDL {
 const int ScreenWidth = 800;
 const int ScreenHeight = 600;
+const int AtlasSize = 1024; // texture atlas pages are AtlasSize squared
+const std::size_t TextureBudget = 256u << 20; // bytes of resident textures
 } // namespace SDL
 
 namespace Assets {
-const std::string Player = "./Assets/Tmp/character.png";
-const std::string Bullets = "./Assets/Bullets/bullets.png";
-const std::string PlayerBullet = "./Assets/Tmp/player_bullet.png";
-const std::string Dummy = "./Assets/Tmp/dummy.png";
+constexpr char Player[] = "./Assets/Tmp/character.png";
+constexpr char PlayerBullet[] = "./Assets/Tmp/player_bullet.png";
+constexpr char Dummy[] = "./Assets/Tmp/dummy.png";
+const std::string Manifest = "./Assets/assets.manifest";
+const std::string Pack = "./Assets/assets.pack"; // baked by `make pack`
+
+// Clips of the manifest
+const std::string PlayerIdleClip = "player_idle";
+const std::string PlayerBulletClip = "player_bullet";
+const std::string DummyClip = "dummy";
+
+// Ids of the images a clip falls back to when the manifest lacks it, hashed
+// at compile time
+constexpr TextureId PlayerTexture(Player);
+constexpr TextureId PlayerBulletTexture(PlayerBullet);
+constexpr TextureId DummyTexture(Dummy);
 } // namespace Assets
 
 } // namespace Global
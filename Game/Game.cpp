@@ -1,14 +1,22 @@
 #include "Game.h"
 #include "Definitions.h"
+#include "../Engine/Profiler.h"
 #include <algorithm>
 #include <iostream>
+#include <memory_resource>
+#include <thread>
 #include <vector>
 
-Game::Game() {
+Game::Game(const bool headless) {
   int rendererFlags, windowFlags;
   rendererFlags = SDL_RENDERER_ACCELERATED;
   windowFlags = 0;
 
+  if (headless) {
+    initializeHeadless();
+    return;
+  }
+
   if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
     std::cout << "Couldn't initialize SDL: " << SDL_GetError() << std::endl;
   }
@@ -36,163 +44,399 @@ Game::Game() {
 Game::~Game() {
   SDL_DestroyRenderer(m_renderer);
   SDL_DestroyWindow(m_window);
+  SDL_FreeSurface(m_headlessTarget);
+}
+
+void Game::initializeHeadless() {
+  // No display needed: the dummy video driver, and a software renderer
+  // drawing into a surface
+  SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+  if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_TIMER) < 0) {
+    std::cout << "Couldn't initialize SDL: " << SDL_GetError() << std::endl;
+  }
+
+  m_headlessTarget = SDL_CreateRGBSurfaceWithFormat(
+      0, Global::SDL::ScreenWidth, Global::SDL::ScreenHeight, 32,
+      SDL_PIXELFORMAT_RGBA32);
+  if (m_headlessTarget) {
+    m_renderer = SDL_CreateSoftwareRenderer(m_headlessTarget);
+  }
+  if (m_renderer) {
+    initialize();
+  } else {
+    std::cout << "Couldn't create renderer: " << SDL_GetError() << std::endl;
+  }
+
+  m_isInitialized = bool(m_renderer);
 }
 
 void Game::StartGame() {
-  m_quitGame |= !m_isInitialized;
+  if (!m_isInitialized) {
+    return;
+  }
+
+  // SDL only allows events and rendering on the thread owning the window,
+  // so this thread captures input and renders, and the model runs on its
+  // own
+  PROFILE_THREAD("Render");
+  std::thread model(&Game::runModel, this);
+  m_frameScheduler.reset();
+  const Uint64 logInterval =
+      Uint64(Global::Metrics::LogInterval * SDL_GetPerformanceFrequency());
+  Uint64 nextLog = SDL_GetPerformanceCounter() + logInterval;
   while (!m_quitGame) {
-    updateModel();
-    if (m_frameTimer.triggered()) {
+    // Sleeps in the event queue until input arrives or a frame is due
+    processInput(m_frameScheduler.getMsToNextStep());
+    if (m_frameScheduler.advance() > 0) {
       composeFrame();
     }
+    if (SDL_GetPerformanceCounter() >= nextLog) {
+      logMetrics();
+      nextLog += logInterval;
+    }
+  }
+  model.join();
+  PROFILE_WRITE(Global::Trace::FilePath);
 
-    m_modelTimer.waitUntilNextTrigger();
+  const Uint64 checksum = computeChecksum();
+  if (m_recorder.isRecording() && m_recorder.finish(m_tick, checksum)) {
+    std::cout << "Recorded " << m_tick << " updates, state checksum "
+              << std::hex << checksum << std::dec << std::endl;
   }
+
+  const JitterStats &jitter = m_modelScheduler.getJitter();
+  std::cout << "Model update lateness: mean " << jitter.meanMs << " ms, max "
+            << jitter.maxMs << " ms, " << jitter.dropped << " of "
+            << jitter.steps + jitter.dropped << " updates dropped"
+            << std::endl;
+
+  const BatchStats &batches = m_spriteBatch.getStats();
+  if (batches.frames > 0) {
+    std::cout << "Rendering: " << batches.sprites / batches.frames
+              << " sprites in " << batches.drawCalls / batches.frames
+              << " draw calls per frame on average" << std::endl;
+  }
+  std::cout << "Textures: " << m_textureMgr->getResidentBytes() / 1024
+            << " KiB resident, " << m_textureMgr->getEvictionCount()
+            << " evictions" << std::endl;
   return;
 }
 
-std::vector<KbdEvents> Game::processInput() {
-  std::vector<KbdEvents> ret;
+void Game::runModel() {
+  PROFILE_THREAD("Model");
+  m_modelScheduler.reset();
+  while (!m_quitGame) {
+    // Each update covers the step length up to the time it was due
+    const unsigned int steps = m_modelScheduler.advance();
+    const Uint64 step = m_modelScheduler.getStepLength();
+    const Uint64 lastTickEnd = m_modelScheduler.getStepTime();
+    for (unsigned int i = 0; i < steps; ++i) {
+      const Uint64 start = SDL_GetPerformanceCounter();
+      updateModel(lastTickEnd - (steps - 1 - i) * step);
+      m_tickTimes.record(countsToUs(SDL_GetPerformanceCounter() - start));
+      m_liveBullets.set(m_playerBullets.size());
+    }
+    if (steps > 0) {
+      publishSnapshot();
+    }
+    m_modelScheduler.waitForNextStep();
+  }
+}
+
+void Game::processInput(const Uint32 timeoutMs) {
   SDL_Event event;
-  while (SDL_PollEvent(&event)) {
+  bool hasEvent = SDL_WaitEventTimeout(&event, int(timeoutMs)) != 0;
+  PROFILE_SCOPE("processInput"); // not counting the wait
+  for (; hasEvent; hasEvent = SDL_PollEvent(&event) != 0) {
+    const Uint64 now = SDL_GetPerformanceCounter();
+    KbdEvents kbdEvent;
+    bool isKbdEvent = false;
     switch (event.type) {
     case SDL_QUIT: {
       m_quitGame = true;
       break;
     }
     case SDL_KEYDOWN: {
-      const auto &keysDown = processKeydown(&event.key);
-      ret.reserve(ret.size() + keysDown.size());
-      ret.insert(ret.end(), keysDown.begin(), keysDown.end());
+      if (event.key.keysym.scancode == SDL_SCANCODE_F9) {
+        PROFILE_WRITE(Global::Trace::FilePath);
+      } else if (event.key.keysym.scancode == SDL_SCANCODE_F10 &&
+                 event.key.repeat == 0) {
+        m_showOverlay = !m_showOverlay;
+      }
+      isKbdEvent = processKeydown(&event.key, kbdEvent);
       break;
     }
     case SDL_KEYUP: {
-      const auto &keysUp = processKeyup(&event.key);
-      ret.reserve(ret.size() + keysUp.size());
-      ret.insert(ret.end(), keysUp.begin(), keysUp.end());
+      isKbdEvent = processKeyup(&event.key, kbdEvent);
       break;
     }
     default: {
       break;
     }
     }
+
+    if (isKbdEvent) {
+      queueEvent(kbdEvent, now);
+    }
+  }
+
+  if (m_keysDropped) {
+    resyncKeys(SDL_GetPerformanceCounter());
+  }
+}
+
+void Game::queueEvent(const KbdEvents event, const Uint64 time) {
+  // Events beyond the queue capacity are dropped, and the keys are resynced
+  // once there is room again
+  if (m_pendingEvents.push({event, time})) {
+    m_queuedKeys.apply(event);
+  } else {
+    m_keysDropped = true;
   }
-  return ret;
 }
 
-std::vector<KbdEvents> Game::processKeydown(SDL_KeyboardEvent *event) {
-  std::vector<KbdEvents> ret;
+// Scancode of every key, in Key order
+static const SDL_Scancode KeyScancodes[] = {
+    SDL_SCANCODE_UP,    SDL_SCANCODE_DOWN,  SDL_SCANCODE_LEFT,
+    SDL_SCANCODE_RIGHT, SDL_SCANCODE_LCTRL, SDL_SCANCODE_SPACE};
+static_assert(sizeof(KeyScancodes) / sizeof(KeyScancodes[0]) ==
+                  std::size_t(Key::Count),
+              "every key needs a scancode");
+
+void Game::resyncKeys(const Uint64 time) {
+  // Queue the transitions that bring the model's keys back to the ones held
+  // now, so a dropped key up doesn't leave a key stuck down
+  m_keysDropped = false;
+  const Uint8 *held = SDL_GetKeyboardState(nullptr);
+  for (std::size_t i = 0; i < std::size_t(Key::Count); ++i) {
+    const Key key = Key(i);
+    const bool down = held[KeyScancodes[i]] != 0;
+    if (down != m_queuedKeys.isDown(key)) {
+      queueEvent(toKbdEvent(key, down), time);
+    }
+  }
+}
+
+bool Game::processKeydown(SDL_KeyboardEvent *event, KbdEvents &kbdEvent) {
   if (event->repeat != 0) {
-    return ret;
+    return false;
   }
   switch (event->keysym.scancode) {
   case SDL_SCANCODE_UP:
-    ret.push_back(KbdEvents::Up_KeyDown);
-    break;
+    kbdEvent = KbdEvents::Up_KeyDown;
+    return true;
   case SDL_SCANCODE_DOWN:
-    ret.push_back(KbdEvents::Down_KeyDown);
-    break;
+    kbdEvent = KbdEvents::Down_KeyDown;
+    return true;
   case SDL_SCANCODE_LEFT:
-    ret.push_back(KbdEvents::Left_KeyDown);
-    break;
+    kbdEvent = KbdEvents::Left_KeyDown;
+    return true;
   case SDL_SCANCODE_RIGHT:
-    ret.push_back(KbdEvents::Right_KeyDown);
-    break;
+    kbdEvent = KbdEvents::Right_KeyDown;
+    return true;
   case SDL_SCANCODE_LCTRL:
-    ret.push_back(KbdEvents::LCtrl_KeyDown);
-    break;
+    kbdEvent = KbdEvents::LCtrl_KeyDown;
+    return true;
   case SDL_SCANCODE_SPACE:
-    ret.push_back(KbdEvents::Space_KeyDown);
-    break;
+    kbdEvent = KbdEvents::Space_KeyDown;
+    return true;
   default:
-    break;
+    return false;
   }
-  return ret;
 }
 
-std::vector<KbdEvents> Game::processKeyup(SDL_KeyboardEvent *event) {
-  std::vector<KbdEvents> ret;
+bool Game::processKeyup(SDL_KeyboardEvent *event, KbdEvents &kbdEvent) {
   if (event->repeat != 0) {
-    return ret;
+    return false;
   }
   switch (event->keysym.scancode) {
   case SDL_SCANCODE_UP:
-    ret.push_back(KbdEvents::Up_KeyUp);
-    break;
+    kbdEvent = KbdEvents::Up_KeyUp;
+    return true;
   case SDL_SCANCODE_DOWN:
-    ret.push_back(KbdEvents::Down_KeyUp);
-    break;
+    kbdEvent = KbdEvents::Down_KeyUp;
+    return true;
   case SDL_SCANCODE_LEFT:
-    ret.push_back(KbdEvents::Left_KeyUp);
-    break;
+    kbdEvent = KbdEvents::Left_KeyUp;
+    return true;
   case SDL_SCANCODE_RIGHT:
-    ret.push_back(KbdEvents::Right_KeyUp);
-    break;
+    kbdEvent = KbdEvents::Right_KeyUp;
+    return true;
   case SDL_SCANCODE_LCTRL:
-    ret.push_back(KbdEvents::LCtrl_KeyUp);
-    break;
+    kbdEvent = KbdEvents::LCtrl_KeyUp;
+    return true;
   case SDL_SCANCODE_SPACE:
-    ret.push_back(KbdEvents::Space_KeyUp);
-    break;
+    kbdEvent = KbdEvents::Space_KeyUp;
+    return true;
   default:
-    break;
+    return false;
   }
-  return ret;
 }
 
-void Game::updateModel() {
-  // Get time since last loop
-  const Uint32 dt = m_modelTimer.getTimeSinceLastCall();
+void Game::updateModel(const Uint64 tickEnd) {
+  const std::size_t nEvents = takeEvents(tickEnd);
+  stepModel(Span<const TickEvent>(m_tickEvents.data(), nEvents));
+}
 
-  // Get events
-  const auto &events = processInput();
+std::size_t Game::takeEvents(const Uint64 tickEnd) {
+  const Uint32 dt = Uint32(1000 / Global::Game::ModelRate);
+
+  // Take the events captured before the end of this update, placed at the
+  // time they were captured within it
+  const Uint64 tickStart = tickEnd - m_modelScheduler.getStepLength();
+  const double countsPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+  const Uint64 now = SDL_GetPerformanceCounter();
+  std::size_t nEvents = 0;
+  const InputEvent *input;
+  while (nEvents < m_tickEvents.size() &&
+         (input = m_pendingEvents.peek()) && input->time < tickEnd) {
+    const double offset =
+        input->time > tickStart ? (input->time - tickStart) / countsPerMs
+                                : 0.0;
+    m_tickEvents[nEvents++] = {input->event,
+                               float(std::min(offset, double(dt)))};
+    if (input->time <= now) {
+      m_inputLatencies.record(countsToUs(now - input->time));
+    }
+    m_pendingEvents.pop();
+  }
+  return nEvents;
+}
+
+void Game::stepModel(const Span<const TickEvent> &events) {
+  PROFILE_SCOPE("stepModel");
+  const NoAllocationScope noAllocations(m_checkAllocations);
+  m_tickArena.reset();
+
+  // Fixed time step
+  const Uint32 dt = Uint32(1000 / Global::Game::ModelRate);
+
+  if (m_recorder.isRecording()) {
+    m_recorder.record(m_tick, events);
+  }
+  ++m_tick;
 
   // Update player
   m_player.update(dt, events);
 
   // Spawn bullets
   if (m_player.shouldSpawnBullet()) {
-    m_playerBullet.setDestination(
-        {m_player.getOppositeX(),
-         (m_player.getPosY() + m_player.getOppositeY()) / 2, 0.02f, 0.02f});
-    m_playerBullets.emplace_back(m_playerBullet);
+    m_playerEmitter.emit(m_playerBullets, m_player.getOppositeX(),
+                         (m_player.getPosY() + m_player.getOppositeY()) / 2);
+  }
+
+  // Update scene entities and bullets
+  m_world.integrate(dt, m_jobs.get());
+  m_world.updateLifespans(dt);
+  m_world.advanceTime(dt);
+  m_playerBullets.update(dt, m_jobs.get());
+
+  // Collisions
+  resolveCollisions();
+
+  // Remove dying bullets
+  m_playerBullets.removeDead();
+}
+
+void Game::resolveCollisions() {
+  PROFILE_SCOPE("resolveCollisions");
+  m_collisionGrid.clear();
+  m_world.addColliders(m_collisionGrid, EnemyLayer, PlayerBulletLayer);
+  m_playerBullets.addColliders(m_collisionGrid, PlayerBulletLayer, EnemyLayer);
+  m_collisionGrid.findPairs(m_collisions, m_jobs.get(), &m_tickArena);
+
+  // Sweep the candidates, so fast bullets can't skip over thin targets
+  std::pmr::vector<CollisionImpact> impacts(&m_tickArena);
+  impacts.reserve(m_collisions.size());
+  for (const auto &pair : m_collisions) {
+    const Collider &first = m_collisionGrid.getCollider(pair.first);
+    const Collider &second = m_collisionGrid.getCollider(pair.second);
+    const bool firstIsBullet = first.layer & PlayerBulletLayer;
+    const Collider &bullet = firstIsBullet ? first : second;
+    const Collider &target = firstIsBullet ? second : first;
+    float time;
+    if (sweptOverlap(bullet.previous, bullet.current, target.previous,
+                     target.current, time)) {
+      impacts.push_back({time, bullet.owner, target.owner});
+    }
   }
 
-  // Update bullets
-  for (auto &bullet : m_playerBullets) {
-    bullet.update(dt);
-    if (m_dummy.isColiding(bullet)) {
-      bullet.hitted();
+  // Impacts are applied in the order they happened, ties broken by owner,
+  // and a bullet is spent on the first target it reaches
+  std::sort(impacts.begin(), impacts.end(),
+            [](const CollisionImpact &a, const CollisionImpact &b) {
+              if (a.time != b.time) {
+                return a.time < b.time;
+              }
+              if (a.first != b.first) {
+                return a.first < b.first;
+              }
+              return a.second < b.second;
+            });
+  for (const auto &impact : impacts) {
+    if (!m_playerBullets.isAlive(impact.first)) {
+      continue;
     }
+    m_world.applyDamage(m_world.getEntity(impact.second),
+                        m_playerBullets.getDamage(impact.first));
+    m_playerBullets.hitted(impact.first);
   }
+  m_world.removeDefeated();
+}
 
-  // Remove dying bullets
-  m_playerBullets.erase(std::remove_if(m_playerBullets.begin(),
-                                       m_playerBullets.end(),
-                                       [](const Projectile &bullet) {
-                                         return bullet.endedLifespan();
-                                       }),
-                        m_playerBullets.end());
+Uint64 Game::computeChecksum() const {
+  StateHash hash;
+  m_player.hashState(hash);
+  m_world.hashState(hash);
+  m_playerBullets.hashState(hash);
+  return hash.getValue();
+}
+
+void Game::publishSnapshot() {
+  RenderSnapshot &snapshot = m_snapshots.getWriteBuffer();
+  snapshot.clear();
+
+  // Render objects
+  m_player.render(snapshot);
+  m_world.render(snapshot);
+  m_playerBullets.render(snapshot);
 
   // Test stuff
-  m_testAnimation.update(dt);
+  m_testAnimation.render(snapshot, {0.125f, 0.167f, 0.15f, 0.25f},
+                         {0.125f, 0.167f, 0.15f, 0.25f}, m_world.getTime());
+
+  snapshot.setTiming(m_modelScheduler.getStepTime(),
+                     m_modelScheduler.getStepLength());
+  m_snapshots.publish();
 }
 
 void Game::composeFrame() {
+  PROFILE_SCOPE("composeFrame");
+  const Uint64 start = SDL_GetPerformanceCounter();
+
   // Render background
   SDL_SetRenderDrawColor(m_renderer, 96, 128, 255, 255);
   SDL_RenderClear(m_renderer);
 
-  // Render objects
-  m_player.render(m_renderer);
-  m_dummy.render(m_renderer);
-  for (auto &bullet : m_playerBullets) {
-    bullet.render(m_renderer);
+  // Render latest model state, interpolated to the current time
+  m_snapshots.fetch();
+  const RenderSnapshot &snapshot = m_snapshots.getReadBuffer();
+  m_textureMgr->BeginFrame();
+  m_spriteBatch.clear();
+  snapshot.render(m_spriteBatch, *m_textureMgr,
+                  snapshot.getAlpha(SDL_GetPerformanceCounter()));
+  m_spriteBatch.render(m_renderer);
+  m_drawCalls.set(m_spriteBatch.getDrawCalls());
+  m_textureSwitches.set(m_spriteBatch.getTextureSwitches());
+  if (m_showOverlay) {
+    renderOverlay();
   }
-
-  // Test stuff
-  m_testAnimation.render(m_renderer, {100, 100, 120, 150});
+  const Uint64 presentStart = SDL_GetPerformanceCounter();
+  m_composeTimes.record(countsToUs(presentStart - start));
 
   // Present rendered objects
+  PROFILE_SCOPE("SDL_RenderPresent");
   SDL_RenderPresent(m_renderer);
+  m_presentTimes.record(countsToUs(SDL_GetPerformanceCounter() -
+                                   presentStart));
 }
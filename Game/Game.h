@@ -1,15 +1,52 @@
 #pragma once
 
+#include "../Engine/Allocations.h"
+#include "../Engine/AssetManifest.h"
+#include "../Engine/Collision.h"
 #include "../Engine/Components.h"
 #include "../Engine/Components_forward.h"
+#include "../Engine/FrameArena.h"
+#include "../Engine/Input.h"
+#include "../Engine/InputRecording.h"
+#include "../Engine/JobSystem.h"
+#include "../Engine/Metrics.h"
+#include "../Engine/Projectiles.h"
+#include "../Engine/RenderSnapshot.h"
+#include "../Engine/Scheduler.h"
+#include "../Engine/SpriteBatch.h"
+#include "../Engine/SpscQueue.h"
 #include "../Engine/TextureManager.h"
+#include "../Engine/TripleBuffer.h"
+#include "../Engine/World.h"
+#include "Definitions.h"
 #include <SDL2/SDL.h>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <string>
 #include <vector>
 
+struct BenchmarkStats {
+  unsigned int ticks = 0;
+  double seconds = 0.0;
+  double ticksPerSecond = 0.0;
+  double meanEntities = 0.0; // live player, scene entities and bullets
+  double nsPerEntity = 0.0;  // per entity and tick
+};
+
+struct ReplayStats {
+  bool loaded = false;
+  unsigned int ticks = 0;
+  double seconds = 0.0;
+  double ticksPerSecond = 0.0;
+  Uint64 checksum = 0;         // of the model state after the replay
+  Uint64 recordedChecksum = 0; // at the end of the recorded session
+};
+
 class Game {
 public:
-  Game();
+  // Headless games have no window and draw into an offscreen surface
+  explicit Game(const bool headless = false);
   ~Game();
   Game(const Game &) = delete;            // no copy
   Game &operator=(const Game &) = delete; // no copy-assignment
@@ -18,35 +55,99 @@ public:
 
 public:
   void StartGame();
+  // Runs the model as fast as possible on a synthetic input script, keeping
+  // the player bullets topped up to the given load
+  BenchmarkStats RunBenchmark(const unsigned int ticks,
+                              const unsigned int bullets);
+  // Records the input of the next StartGame session to a file
+  void RecordInput(const std::string &filePath);
+  // Runs the model as fast as possible on recorded input, with the same
+  // fixed time step. Replays of the same recording end in the same state.
+  ReplayStats RunReplay(const std::string &filePath);
+  bool isInitialized() const { return m_isInitialized; }
+  // Asserts that model updates do not allocate, in builds tracking
+  // allocations. Meant for steady state, once buffers reached their size.
+  void setAllocationChecks(const bool enabled) {
+    m_checkAllocations = enabled;
+  }
 
 private:
   void initialize();
+  void initializeHeadless();
+  void loadAssets(AssetManifest &manifest);
+  AnimationClipId loadClip(const AssetManifest &manifest,
+                           const std::string &name, const TextureId fallback);
+  void runModel();
 
-  std::vector<KbdEvents> processInput();
-  std::vector<KbdEvents> processKeydown(SDL_KeyboardEvent *event);
-  std::vector<KbdEvents> processKeyup(SDL_KeyboardEvent *event);
+  void processInput(const Uint32 timeoutMs);
+  bool processKeydown(SDL_KeyboardEvent *event, KbdEvents &kbdEvent);
+  bool processKeyup(SDL_KeyboardEvent *event, KbdEvents &kbdEvent);
+  void queueEvent(const KbdEvents event, const Uint64 time);
+  void resyncKeys(const Uint64 time);
 
-  void updateModel();
+  void updateModel(const Uint64 tickEnd);
+  std::size_t takeEvents(const Uint64 tickEnd);
+  void stepModel(const Span<const TickEvent> &events);
+  void resolveCollisions();
+  Uint64 computeChecksum() const;
+  void publishSnapshot();
   void composeFrame();
+  void logMetrics();
+  void renderOverlay();
 
 private:
   // General
   bool m_isInitialized = false;
-  bool m_quitGame = false;
+  std::atomic<bool> m_quitGame{false};
   SDL_Renderer *m_renderer = nullptr;
   SDL_Window *m_window = nullptr;
+  SDL_Surface *m_headlessTarget = nullptr;
   std::shared_ptr<TextureManager> m_textureMgr = nullptr;
+  std::shared_ptr<JobSystem> m_jobs = nullptr;
+  AnimationLibrary m_animations;
+
+  // Input handed from the render thread to the model thread
+  SpscQueue<InputEvent, Global::Input::BufferCapacity> m_pendingEvents;
+  std::array<TickEvent, Global::Input::BufferCapacity> m_tickEvents;
+  KeyboardState m_queuedKeys; // as queued so far, render thread only
+  bool m_keysDropped = false;  // queue overflowed since the last resync
+  InputRecorder m_recorder;  // model thread only while the game runs
+  Uint32 m_tick = 0;         // model updates so far
+
+  // Model states handed from the model thread to the render thread
+  TripleBuffer<RenderSnapshot> m_snapshots;
+  SpriteBatch m_spriteBatch; // render thread only
+
+  // Transient data of a model update, released when the next one starts
+  FrameArena m_tickArena{Global::Game::TickArenaSize};
+  bool m_checkAllocations = false;
+
+  // Scene entities
+  World m_world;
 
   // Player objects
   Player m_player;
-  Projectile m_playerBullet;
-  std::vector<Projectile> m_playerBullets;
+  BulletEmitter m_playerEmitter;
+  ProjectilePool m_playerBullets;
+
+  // Collisions
+  SpatialHashGrid m_collisionGrid;
+  std::vector<CollisionPair> m_collisions;
+
+  // Pacing
+  Scheduler m_modelScheduler;
+  Scheduler m_frameScheduler;
 
-  // Timers
-  Timer m_modelTimer;
-  Timer m_frameTimer;
+  // Metrics, logged and reset by the render thread every LogInterval
+  Histogram m_tickTimes;      // model thread
+  Histogram m_inputLatencies; // from capture to the update applying it
+  Histogram m_composeTimes;   // render thread, up to the present
+  Histogram m_presentTimes;
+  Gauge m_liveBullets;
+  Gauge m_drawCalls;
+  Gauge m_textureSwitches;
+  bool m_showOverlay = false; // toggled with F10
 
   // Testing
-  Object m_dummy;
   Animation m_testAnimation;
 };
@@ -1,27 +1,29 @@
 #include "Definitions.h"
 #include "Game.h"
+#include <algorithm>
+#include <iostream>
 
 void Game::initialize() {
-  m_textureMgr = std::make_shared<TextureManager>(m_renderer);
+  m_jobs = std::make_shared<JobSystem>(std::max(SDL_GetCPUCount() - 1, 0));
+  m_textureMgr = std::make_shared<TextureManager>(m_renderer,
+                                                  Global::SDL::AtlasSize);
+  m_textureMgr->setBudget(Global::SDL::TextureBudget);
+  AssetManifest manifest;
+  loadAssets(manifest);
 
-  m_modelTimer.setInterval(Uint32(1000 / Global::Game::ModelRate));
-  m_frameTimer.setInterval(Uint32(1000 / Global::Game::FrameRate));
+  m_modelScheduler.setRate(Global::Game::ModelRate);
+  m_modelScheduler.setMaxCatchUp(Global::Game::MaxCatchUp);
+  m_frameScheduler.setRate(Global::Game::FrameRate);
+  m_collisionGrid.setCellSize(Global::Game::CollisionCellSize);
 
   m_player.setDestination({0.1f, 0.5f, 0.1f, 0.1f});
   m_player.setHealth(100);
   m_player.setFireRate(3);
 
   // Load animations for player
-  // TODO: find some assets to add animations to player states
-  Animation idle;
-  for (unsigned int i = 0; i < 1; ++i) {
-    idle.addFrame({
-        m_textureMgr->GetTexture(Global::Assets::Player),
-        {0, 0, 0, 0},
-        100 /*time*/,
-        true /*queryTexture*/
-    });
-  }
+  const Animation idle(m_animations.getClip(
+      loadClip(manifest, Global::Assets::PlayerIdleClip,
+               Global::Assets::PlayerTexture)));
   m_player.addAnimation(ObjState::Idle, idle);
   m_player.addAnimation(ObjState::Moving, idle);
   m_player.addAnimation(ObjState::Jumping, idle);
@@ -30,74 +32,58 @@ void Game::initialize() {
   m_player.addAnimation(ObjState::FiringAndJumping, idle);
 
   // Player Bullet
-  m_playerBullet.setDamage(5);
-  m_playerBullet.setLifeSpan(3000);
-  m_playerBullet.setVelocityX(0.00015f);
-  m_playerBullet.setGravitySensitive(false);
-  Animation bulletAnim;
-  // bullet up
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {13, 12, 6, 10},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  // bullet up-right
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {44, 13, 9, 9},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  // bullet right
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {21, 14, 9, 9},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  // bullet down-right
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {33, 13, 9, 9},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  // bullet down
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {13, 12, 6, 10},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  // bullet down-left
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {44, 13, 9, 9},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  // bullet left
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {21, 14, 9, 9},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  // bullet up-left
-  bulletAnim.addFrame({
-      m_textureMgr->GetTexture(Global::Assets::Bullets),
-      {33, 13, 9, 9},
-      200 /*time*/,
-      false /*queryTexture*/
-  });
-  m_playerBullet.setState(ObjState::Moving);
-  m_playerBullet.addAnimation(ObjState::Moving, bulletAnim);
-  m_playerBullet.scale(0.05f);
+  m_playerBullets.setCapacity(Global::Game::MaxProjectiles);
+  m_playerBullets.setDamage(5);
+  m_playerBullets.setLifeSpan(3000);
+  m_playerBullets.setSize(0.02f, 0.02f);
+  m_playerBullets.setGravitySensitive(false);
+  m_playerEmitter.setPattern(EmitterPattern::Spread);
+  m_playerEmitter.setCount(1);
+  m_playerEmitter.setSpeed(0.00015f);
+  m_playerBullets.setAnimation(m_animations.getClip(
+      loadClip(manifest, Global::Assets::PlayerBulletClip,
+               Global::Assets::PlayerBulletTexture)));
 
   // Test stuff
-  m_dummy.setDestination({0.8f, 0.9f, 0.1f, 0.1f});
-  m_dummy.setAnimation(Animation(
-      {AnimationFrame(m_textureMgr->GetTexture(Global::Assets::Dummy),
-                      {} /*src*/, 100 /*ticks*/, true /*queryTexture*/)}));
+  const AnimationClipId dummyClip =
+      loadClip(manifest, Global::Assets::DummyClip,
+               Global::Assets::DummyTexture);
+  // Without health it only soaks up bullets, like a training dummy should
+  const Entity dummy =
+      m_world.createEntity(TransformComponent | AnimationComponent);
+  m_world.setTransform(dummy, {0.8f, 0.9f, 0.1f, 0.1f});
+  m_world.startAnimation(dummy, m_animations.getClip(dummyClip));
+}
+
+void Game::loadAssets(AssetManifest &manifest) {
+  // A baked pack skips image decoding, the text manifest is the fallback
+  std::unique_ptr<AssetPack> pack(new AssetPack());
+  if (pack->open(Global::Assets::Pack)) {
+    pack->readManifest(manifest);
+    m_textureMgr->LoadPack(std::move(pack));
+  } else if (manifest.load(Global::Assets::Manifest)) {
+    m_textureMgr->Preload(manifest.getImages(), m_jobs.get());
+  }
+}
+
+// A clip missing from the manifest shows the whole fallback image instead
+AnimationClipId Game::loadClip(const AssetManifest &manifest,
+                               const std::string &name,
+                               const TextureId fallback) {
+  std::vector<AnimationFrame> frames;
+  const AssetClip *clip = manifest.findClip(name);
+  if (!clip) {
+    std::cout << "Missing animation clip " << name << std::endl;
+    const TextureHandle texture = m_textureMgr->Acquire(fallback);
+    if (texture.isValid()) {
+      frames.emplace_back(texture, SDL_Rect{0, 0, 0, 0}, 0, true);
+    }
+    return m_animations.addClip(frames);
+  }
+  for (const auto &frame : clip->frames) {
+    const bool wholeImage = frame.source.w == 0 || frame.source.h == 0;
+    frames.emplace_back(m_textureMgr->Load(frame.image), frame.source,
+                        frame.ticks, wholeImage);
+  }
+  return m_animations.addClip(frames);
 }
@@ -0,0 +1,93 @@
+#include "Definitions.h"
+#include "Game.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+void logPercentiles(const char *name, const Histogram &histogram) {
+  std::cout << name << " " << histogram.getPercentile(50.0) / 1000.0 << "/"
+            << histogram.getPercentile(99.0) / 1000.0 << "/"
+            << histogram.getPercentile(99.9) / 1000.0 << " ms";
+}
+
+void logGauge(const char *name, const Gauge &gauge) {
+  std::cout << name << " " << gauge.getValue() << " (max " << gauge.getMax()
+            << ")";
+}
+
+} // namespace
+
+void Game::logMetrics() {
+  // Percentiles are p50/p99/p99.9 over the last interval
+  const std::ios::fmtflags flags = std::cout.flags();
+  const std::streamsize precision = std::cout.precision(2);
+  std::cout.setf(std::ios::fixed, std::ios::floatfield);
+  logPercentiles("Tick", m_tickTimes);
+  logPercentiles(" | compose", m_composeTimes);
+  logPercentiles(" | present", m_presentTimes);
+  logPercentiles(" | input", m_inputLatencies);
+  logGauge(" | bullets", m_liveBullets);
+  logGauge(", draw calls", m_drawCalls);
+  logGauge(", texture switches", m_textureSwitches);
+  std::cout << std::endl;
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+
+  m_tickTimes.reset();
+  m_composeTimes.reset();
+  m_presentTimes.reset();
+  m_inputLatencies.reset();
+  m_liveBullets.reset();
+  m_drawCalls.reset();
+  m_textureSwitches.reset();
+}
+
+void Game::renderOverlay() {
+  // One row per histogram with its p50, p99 and p99.9 as bars, the overlay
+  // spans OverlayScale and a white mark shows the frame budget. The last
+  // row is the bullet count against the pool capacity.
+  const int left = 8, top = 8, width = 200, barHeight = 3, rowHeight = 12;
+  const Histogram *histograms[] = {&m_tickTimes, &m_composeTimes,
+                                   &m_presentTimes, &m_inputLatencies};
+  const double percentiles[] = {50.0, 99.0, 99.9};
+  const SDL_Color colors[] = {{64, 224, 64, 255}, {240, 200, 32, 255},
+                              {240, 48, 48, 255}};
+  const int nRows = sizeof(histograms) / sizeof(histograms[0]) + 1;
+  const auto barWidth = [width](const double fraction) {
+    return int(std::min(fraction, 1.0) * width);
+  };
+
+  SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 160);
+  const SDL_Rect panel = {left - 4, top - 4, width + 8,
+                          nRows * rowHeight + 4};
+  SDL_RenderFillRect(m_renderer, &panel);
+
+  const double scaleUs = Global::Metrics::OverlayScale * 1e6;
+  int y = top;
+  for (const Histogram *histogram : histograms) {
+    for (int i = 0; i < 3; ++i) {
+      const SDL_Rect bar = {
+          left, y + i * barHeight,
+          barWidth(histogram->getPercentile(percentiles[i]) / scaleUs),
+          barHeight};
+      SDL_SetRenderDrawColor(m_renderer, colors[i].r, colors[i].g,
+                             colors[i].b, colors[i].a);
+      SDL_RenderFillRect(m_renderer, &bar);
+    }
+    y += rowHeight;
+  }
+  const SDL_Rect bullets = {
+      left, y,
+      barWidth(double(m_liveBullets.getValue()) / Global::Game::MaxProjectiles),
+      barHeight * 3};
+  SDL_SetRenderDrawColor(m_renderer, 64, 160, 255, 255);
+  SDL_RenderFillRect(m_renderer, &bullets);
+
+  const int budget = barWidth(1e6 / Global::Game::FrameRate / scaleUs);
+  SDL_SetRenderDrawColor(m_renderer, 255, 255, 255, 255);
+  SDL_RenderDrawLine(m_renderer, left + budget, top, left + budget,
+                     top + (nRows - 1) * rowHeight - 1);
+  SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
+}
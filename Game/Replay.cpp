@@ -0,0 +1,46 @@
+#include "Definitions.h"
+#include "Game.h"
+#include "../Engine/FixedPoint.h"
+#include <iostream>
+
+void Game::RecordInput(const std::string &filePath) {
+  m_recorder.start(filePath, Global::Game::ModelRate);
+}
+
+ReplayStats Game::RunReplay(const std::string &filePath) {
+  ReplayStats stats;
+  InputReplay replay;
+  if (!m_isInitialized || !replay.load(filePath)) {
+    return stats;
+  }
+  if (replay.getModelRate() != Global::Game::ModelRate) {
+    std::cout << "Input recorded at " << replay.getModelRate()
+              << " updates per second, the model runs at "
+              << Global::Game::ModelRate << std::endl;
+    return stats;
+  }
+  if (replay.isFixedPoint() != UseFixedPointPhysics) {
+    std::cout << "Input recorded with "
+              << (replay.isFixedPoint() ? "fixed" : "floating")
+              << "-point physics, the model uses the other" << std::endl;
+    return stats;
+  }
+
+  // Ticks run back to back, with the events recorded for each of them
+  const Uint64 start = SDL_GetPerformanceCounter();
+  for (Uint32 tick = 0; tick < replay.getTickCount(); ++tick) {
+    stepModel(replay.getEvents(tick));
+    publishSnapshot();
+  }
+  const Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+
+  stats.loaded = true;
+  stats.ticks = replay.getTickCount();
+  stats.seconds = double(elapsed) / SDL_GetPerformanceFrequency();
+  if (stats.seconds > 0.0) {
+    stats.ticksPerSecond = stats.ticks / stats.seconds;
+  }
+  stats.checksum = computeChecksum();
+  stats.recordedChecksum = replay.getChecksum();
+  return stats;
+}
@@ -1,8 +1,32 @@
 #include "Game/Game.h"
 #include <iostream>
+#include <string>
 
+// testGame --record <file> plays and records the input of the session
+// testGame --replay <file> runs a recorded session headless
 int main(int argc, char *argv[]) {
+  const std::string option = argc > 2 ? argv[1] : "";
+  if (option == "--replay") {
+    Game game(true);
+    const ReplayStats stats = game.RunReplay(argv[2]);
+    if (!stats.loaded) {
+      return EXIT_FAILURE;
+    }
+    std::cout << stats.ticks << " updates in " << stats.seconds << " s, "
+              << stats.ticksPerSecond << " updates/s" << std::endl;
+    std::cout << "State checksum " << std::hex << stats.checksum
+              << (stats.checksum == stats.recordedChecksum ? " matches"
+                                                           : " differs from")
+              << " the recorded " << stats.recordedChecksum << std::dec
+              << std::endl;
+    return stats.checksum == stats.recordedChecksum ? EXIT_SUCCESS
+                                                    : EXIT_FAILURE;
+  }
+
   Game game;
+  if (option == "--record") {
+    game.RecordInput(argv[2]);
+  }
   game.StartGame();
   return EXIT_SUCCESS;
 }
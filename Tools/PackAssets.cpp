@@ -0,0 +1,164 @@
+#define SDL_MAIN_HANDLED
+#include "../Engine/AssetManifest.h"
+#include "../Engine/AssetPack.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+// Bakes the images and clips of a text manifest into an asset pack, with
+// the images decoded to RGBA32 so the game can upload them as they are.
+// Usage: packAssets [manifest] [pack]
+namespace {
+
+std::size_t align(const std::size_t offset) {
+  return (offset + PackAlignment - 1) / PackAlignment * PackAlignment;
+}
+
+bool copyName(char (&name)[PackNameLength], const std::string &value) {
+  if (value.size() >= PackNameLength) {
+    std::printf("Name too long for a pack: %s\n", value.c_str());
+    return false;
+  }
+  std::memset(name, 0, PackNameLength);
+  std::memcpy(name, value.data(), value.size());
+  return true;
+}
+
+SDL_Surface *decode(const std::string &filePath) {
+  SDL_Surface *loaded = IMG_Load(filePath.c_str());
+  if (!loaded) {
+    std::printf("Couldn't load %s: %s\n", filePath.c_str(), SDL_GetError());
+    return nullptr;
+  }
+  SDL_Surface *image =
+      SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(loaded);
+  return image;
+}
+
+bool bake(const AssetManifest &manifest,
+          const std::vector<SDL_Surface *> &images,
+          const std::string &filePath) {
+  const std::vector<std::string> &names = manifest.getImages();
+  std::vector<PackImage> packImages(names.size());
+  std::vector<PackClip> packClips(manifest.getClips().size());
+  std::vector<PackFrame> packFrames;
+
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    if (!copyName(packImages[i].name, names[i])) {
+      return false;
+    }
+    packImages[i].width = images[i]->w;
+    packImages[i].height = images[i]->h;
+    packImages[i].pitch = images[i]->w * 4;
+    packImages[i].reserved = 0;
+  }
+
+  for (std::size_t i = 0; i < packClips.size(); ++i) {
+    const AssetClip &clip = manifest.getClips()[i];
+    if (!copyName(packClips[i].name, clip.name)) {
+      return false;
+    }
+    packClips[i].firstFrame = packFrames.size();
+    packClips[i].nFrames = clip.frames.size();
+    for (const auto &frame : clip.frames) {
+      Uint32 image = 0;
+      while (image < names.size() && names[image] != frame.image) {
+        ++image;
+      }
+      if (image == names.size()) {
+        std::printf("Clip %s uses undeclared image %s\n", clip.name.c_str(),
+                    frame.image.c_str());
+        return false;
+      }
+      SDL_Rect source = frame.source;
+      if (source.w == 0 || source.h == 0) {
+        source = {0, 0, images[image]->w, images[image]->h};
+      }
+      packFrames.push_back(
+          {image, source.x, source.y, source.w, source.h, frame.ticks});
+    }
+  }
+
+  // Pixels follow the tables
+  std::size_t offset =
+      sizeof(PackHeader) + packImages.size() * sizeof(PackImage) +
+      packClips.size() * sizeof(PackClip) +
+      packFrames.size() * sizeof(PackFrame);
+  for (auto &image : packImages) {
+    offset = align(offset);
+    image.offset = offset;
+    offset += std::size_t(image.pitch) * image.height;
+  }
+
+  std::ofstream file(filePath, std::ios::binary);
+  if (!file) {
+    std::printf("Couldn't create %s\n", filePath.c_str());
+    return false;
+  }
+  PackHeader header = {};
+  std::memcpy(header.magic, PackMagic, sizeof(PackMagic));
+  header.version = PackVersion;
+  header.nImages = packImages.size();
+  header.nClips = packClips.size();
+  header.nFrames = packFrames.size();
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(packImages.data()),
+             packImages.size() * sizeof(PackImage));
+  file.write(reinterpret_cast<const char *>(packClips.data()),
+             packClips.size() * sizeof(PackClip));
+  file.write(reinterpret_cast<const char *>(packFrames.data()),
+             packFrames.size() * sizeof(PackFrame));
+
+  const char padding[PackAlignment] = {};
+  for (std::size_t i = 0; i < packImages.size(); ++i) {
+    const std::size_t position = file.tellp();
+    file.write(padding, packImages[i].offset - position);
+    SDL_LockSurface(images[i]);
+    const char *pixels = static_cast<const char *>(images[i]->pixels);
+    for (Uint32 row = 0; row < packImages[i].height; ++row) {
+      file.write(pixels + std::size_t(row) * images[i]->pitch,
+                 packImages[i].pitch);
+    }
+    SDL_UnlockSurface(images[i]);
+  }
+  return bool(file);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const std::string manifestPath =
+      argc > 1 ? argv[1] : "./Assets/assets.manifest";
+  const std::string packPath = argc > 2 ? argv[2] : "./Assets/assets.pack";
+
+  AssetManifest manifest;
+  if (!manifest.load(manifestPath)) {
+    return EXIT_FAILURE;
+  }
+
+  IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+  std::vector<SDL_Surface *> images;
+  bool decoded = true;
+  for (const auto &image : manifest.getImages()) {
+    images.push_back(decode(image));
+    decoded = decoded && images.back();
+  }
+  const bool baked = decoded && bake(manifest, images, packPath);
+  for (auto image : images) {
+    SDL_FreeSurface(image);
+  }
+  IMG_Quit();
+
+  if (!baked) {
+    return EXIT_FAILURE;
+  }
+  std::printf("Packed %zu images and %zu clips into %s\n",
+              manifest.getImages().size(), manifest.getClips().size(),
+              packPath.c_str());
+  return EXIT_SUCCESS;
+}